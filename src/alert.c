@@ -0,0 +1,491 @@
+#include "alert.h"
+#include <Ecore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <unistd.h>
+
+#define ALERT_CONFIG_PATH "esysinfo/alerts.conf"
+
+typedef enum
+{
+   ALERT_PROCESS_CPU,
+   ALERT_PROCESS_RSS,
+   ALERT_PROCESS_SIZE,
+   ALERT_PROCESS_THREADS,
+   ALERT_PROCESS_IO,
+   ALERT_PROCESS_GROWTH,
+   ALERT_PROCESS_METRICS,
+} Alert_Process_Metric;
+
+typedef enum
+{
+   SOURCE_PROCESS,
+   SOURCE_SYSTEM,
+} Alert_Source;
+
+// A compiled rule. Thresholds are multiplied by sign so every rule is
+// tested as value * sign > raise, whatever its direction.
+typedef struct _Alert_Rule
+{
+   int    metric;
+   double sign;
+   double raise;
+   double clear;
+} Alert_Rule;
+
+static const struct
+{
+   const char  *name;
+   Alert_Source source;
+   int          metric;
+   Eina_Bool    memory;
+} _metrics[] = {
+   { "process.cpu", SOURCE_PROCESS, ALERT_PROCESS_CPU, EINA_FALSE },
+   { "process.rss", SOURCE_PROCESS, ALERT_PROCESS_RSS, EINA_TRUE },
+   { "process.size", SOURCE_PROCESS, ALERT_PROCESS_SIZE, EINA_TRUE },
+   { "process.threads", SOURCE_PROCESS, ALERT_PROCESS_THREADS, EINA_FALSE },
+   { "process.io", SOURCE_PROCESS, ALERT_PROCESS_IO, EINA_TRUE },
+   { "process.growth", SOURCE_PROCESS, ALERT_PROCESS_GROWTH, EINA_TRUE },
+   { "system.cpu", SOURCE_SYSTEM, ALERT_SYSTEM_CPU, EINA_FALSE },
+   { "system.memory", SOURCE_SYSTEM, ALERT_SYSTEM_MEMORY, EINA_FALSE },
+   { "system.temperature", SOURCE_SYSTEM, ALERT_SYSTEM_TEMPERATURE, EINA_FALSE },
+   { "system.zombies", SOURCE_SYSTEM, ALERT_SYSTEM_ZOMBIES, EINA_FALSE },
+   { "system.processes", SOURCE_SYSTEM, ALERT_SYSTEM_PROCESSES, EINA_FALSE },
+   { "system.load", SOURCE_SYSTEM, ALERT_SYSTEM_LOAD, EINA_FALSE },
+   { "system.forks", SOURCE_SYSTEM, ALERT_SYSTEM_FORKS, EINA_FALSE },
+};
+
+// Process rules come first, from 0 to _process_count - 1.
+static Alert_Rule        *_rules = NULL;
+static Alert_Status      *_status = NULL;
+static int                _count = 0;
+static int                _process_count = 0;
+
+// Worst value, times sign, and worst process of each rule this snapshot.
+static double            *_worst = NULL;
+static const Proc_Stats **_worst_proc = NULL;
+
+static double             _system[ALERT_SYSTEM_METRICS];
+static unsigned int       _zombies = 0;
+static unsigned int       _processes = 0;
+
+static char              *_hook = NULL;
+
+typedef struct _Alert_Parsed
+{
+   char        name[64];
+   int         index;
+   Alert_Rule  rule;
+} Alert_Parsed;
+
+static char *
+_trim(char *text)
+{
+   char *end;
+
+   while (isspace((unsigned char) *text))
+     text++;
+
+   end = text + strlen(text);
+   while (end > text && isspace((unsigned char) end[-1]))
+     *--end = '\0';
+
+   return text;
+}
+
+static Eina_Bool
+_value_parse(const char *text, Eina_Bool memory, double *value)
+{
+   char *end;
+   double scale = 1;
+
+   *value = strtod(text, &end);
+   if (end == text)
+     return EINA_FALSE;
+
+   if (memory)
+     {
+        switch (toupper((unsigned char) *end))
+          {
+           case 'T':
+             scale *= 1024;
+           /* fallthrough */
+           case 'G':
+             scale *= 1024;
+           /* fallthrough */
+           case 'M':
+             scale *= 1024;
+           /* fallthrough */
+           case 'K':
+             scale *= 1024;
+             end++;
+             break;
+          }
+        if (toupper((unsigned char) *end) == 'B')
+          end++;
+     }
+
+   if (*end)
+     return EINA_FALSE;
+
+   *value *= scale;
+
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_rule_parse(char *line, Alert_Parsed *parsed)
+{
+   char *p, metric[64], op[3], raise[64], keyword[16], clear[64];
+   double value;
+   int i, n, count;
+
+   p = strchr(line, ':');
+   if (!p || p == line)
+     return EINA_FALSE;
+
+   *p++ = '\0';
+   eina_strlcpy(parsed->name, _trim(line), sizeof(parsed->name));
+
+   n = sscanf(p, "%63s %2s %63s %15s %63s", metric, op, raise, keyword, clear);
+   if (n != 3 && !(n == 5 && !strcasecmp(keyword, "clear")))
+     return EINA_FALSE;
+
+   count = sizeof(_metrics) / sizeof(_metrics[0]);
+   for (i = 0; i < count; i++)
+     {
+        if (!strcasecmp(_metrics[i].name, metric))
+          break;
+     }
+
+   if (i == count)
+     return EINA_FALSE;
+
+   parsed->index = i;
+   parsed->rule.metric = _metrics[i].metric;
+
+   if (!strcmp(op, ">"))
+     parsed->rule.sign = 1;
+   else if (!strcmp(op, "<"))
+     parsed->rule.sign = -1;
+   else
+     return EINA_FALSE;
+
+   if (!_value_parse(raise, _metrics[i].memory, &value))
+     return EINA_FALSE;
+
+   parsed->rule.raise = parsed->rule.clear = value * parsed->rule.sign;
+
+   if (n == 5)
+     {
+        if (!_value_parse(clear, _metrics[i].memory, &value))
+          return EINA_FALSE;
+
+        // Clearing past the raise threshold would flap.
+        parsed->rule.clear = value * parsed->rule.sign;
+        if (parsed->rule.clear > parsed->rule.raise)
+          parsed->rule.clear = parsed->rule.raise;
+     }
+
+   return EINA_TRUE;
+}
+
+static void
+_rule_add(const Alert_Parsed *parsed, int index)
+{
+   _rules[index] = parsed->rule;
+   _status[index].name = eina_stringshare_add(parsed->name);
+   _status[index].metric = _metrics[parsed->index].name;
+   _status[index].memory = _metrics[parsed->index].memory;
+   _status[index].value = NAN;
+}
+
+static void
+_rules_load(FILE *f)
+{
+   Eina_List *list = NULL, *l;
+   Alert_Parsed *parsed;
+   char buf[1024], *line;
+   int i;
+
+   while (fgets(buf, sizeof(buf), f))
+     {
+        line = _trim(buf);
+        if (!line[0] || line[0] == '#')
+          continue;
+
+        if (!strncasecmp(line, "hook", 4) && isspace((unsigned char) line[4]))
+          {
+             free(_hook);
+             _hook = strdup(_trim(line + 4));
+             continue;
+          }
+
+        parsed = calloc(1, sizeof(Alert_Parsed));
+        if (!parsed) break;
+
+        if (_rule_parse(line, parsed))
+          list = eina_list_append(list, parsed);
+        else
+          free(parsed);
+     }
+
+   _count = eina_list_count(list);
+   if (!_count)
+     return;
+
+   _rules = calloc(_count, sizeof(Alert_Rule));
+   _status = calloc(_count, sizeof(Alert_Status));
+   _worst = calloc(_count, sizeof(double));
+   _worst_proc = calloc(_count, sizeof(Proc_Stats *));
+
+   if (!_rules || !_status || !_worst || !_worst_proc)
+     {
+        _count = 0;
+        EINA_LIST_FREE(list, parsed)
+          free(parsed);
+        return;
+     }
+
+   // Process rules first so a snapshot only walks those per process.
+   i = 0;
+   EINA_LIST_FOREACH(list, l, parsed)
+     {
+        if (_metrics[parsed->index].source == SOURCE_PROCESS)
+          _rule_add(parsed, i++);
+     }
+   _process_count = i;
+
+   EINA_LIST_FREE(list, parsed)
+     {
+        if (_metrics[parsed->index].source == SOURCE_SYSTEM)
+          _rule_add(parsed, i++);
+        free(parsed);
+     }
+}
+
+static void
+_hook_run(const Alert_Status *status)
+{
+   extern char **environ;
+   char name[256], state[64], value[64], pid[64], command[320];
+   char **env;
+   const char *argv[] = { "/bin/sh", "-c", _hook, NULL };
+   int i, n;
+
+   if (!_hook || !_hook[0])
+     return;
+
+   // The child gets its own environment so ours is never touched.
+   snprintf(name, sizeof(name), "ESYSINFO_ALERT_NAME=%s", status->name);
+   snprintf(state, sizeof(state), "ESYSINFO_ALERT_STATE=%s", status->active ? "raised" : "cleared");
+   snprintf(value, sizeof(value), "ESYSINFO_ALERT_VALUE=%g", status->value);
+   snprintf(pid, sizeof(pid), "ESYSINFO_ALERT_PID=%d", status->pid);
+   snprintf(command, sizeof(command), "ESYSINFO_ALERT_COMMAND=%s", status->command);
+
+   for (n = 0; environ[n]; n++);
+
+   env = malloc((n + 6) * sizeof(char *));
+   if (!env) return;
+
+   i = 0;
+   for (int j = 0; j < n; j++)
+     {
+        if (strncmp(environ[j], "ESYSINFO_ALERT_", 15))
+          env[i++] = environ[j];
+     }
+   env[i++] = name;
+   env[i++] = state;
+   env[i++] = value;
+   env[i++] = pid;
+   env[i++] = command;
+   env[i] = NULL;
+
+   // Ecore's SIGCHLD handler reaps the child.
+   if (fork() == 0)
+     {
+        execve(argv[0], (char **) argv, env);
+        _exit(127);
+     }
+
+   free(env);
+}
+
+void
+alert_init(void)
+{
+   const char *dir;
+   char path[PATH_MAX];
+   FILE *f;
+
+   for (int i = 0; i < ALERT_SYSTEM_METRICS; i++)
+     _system[i] = NAN;
+
+   dir = getenv("XDG_CONFIG_HOME");
+   if (dir && dir[0])
+     snprintf(path, sizeof(path), "%s/%s", dir, ALERT_CONFIG_PATH);
+   else if ((dir = getenv("HOME")))
+     snprintf(path, sizeof(path), "%s/.config/%s", dir, ALERT_CONFIG_PATH);
+   else
+     return;
+
+   f = fopen(path, "r");
+   if (!f) return;
+
+   _rules_load(f);
+
+   fclose(f);
+}
+
+void
+alert_shutdown(void)
+{
+   for (int i = 0; i < _count; i++)
+     eina_stringshare_del(_status[i].name);
+
+   free(_rules);
+   free(_status);
+   free(_worst);
+   free(_worst_proc);
+   free(_hook);
+
+   _rules = NULL;
+   _status = NULL;
+   _worst = NULL;
+   _worst_proc = NULL;
+   _hook = NULL;
+   _count = _process_count = 0;
+}
+
+void
+alert_system_set(Alert_System_Metric metric, double value)
+{
+   if (metric < ALERT_SYSTEM_METRICS)
+     _system[metric] = value;
+}
+
+void
+alert_begin(void)
+{
+   _zombies = _processes = 0;
+
+   for (int i = 0; i < _process_count; i++)
+     {
+        _worst[i] = -INFINITY;
+        _worst_proc[i] = NULL;
+     }
+}
+
+void
+alert_process(const Proc_Stats *proc)
+{
+   double row[ALERT_PROCESS_METRICS], value;
+   const Alert_Rule *rule;
+
+   _processes++;
+   if (proc->state && !strcmp(proc->state, "ZOMB"))
+     _zombies++;
+
+   if (!_process_count)
+     return;
+
+   row[ALERT_PROCESS_CPU] = proc->cpu_usage;
+   row[ALERT_PROCESS_RSS] = proc->mem_rss;
+   row[ALERT_PROCESS_SIZE] = proc->mem_size;
+   row[ALERT_PROCESS_THREADS] = proc->numthreads;
+   row[ALERT_PROCESS_IO] = proc->io_read_rate + proc->io_write_rate;
+   row[ALERT_PROCESS_GROWTH] = proc->mem_growth_valid ? proc->mem_growth : NAN;
+
+   for (int i = 0; i < _process_count; i++)
+     {
+        rule = &_rules[i];
+        value = row[rule->metric] * rule->sign;
+        if (value > _worst[i])
+          {
+             _worst[i] = value;
+             _worst_proc[i] = proc;
+          }
+     }
+}
+
+int
+alert_end(void)
+{
+   const Alert_Rule *rule;
+   Alert_Status *status;
+   const Proc_Stats *proc;
+   double value;
+   int i, changed = 0;
+
+   _system[ALERT_SYSTEM_ZOMBIES] = _zombies;
+   _system[ALERT_SYSTEM_PROCESSES] = _processes;
+
+   for (i = _process_count; i < _count; i++)
+     _worst[i] = _system[_rules[i].metric] * _rules[i].sign;
+
+   for (i = 0; i < _count; i++)
+     {
+        rule = &_rules[i];
+        status = &_status[i];
+        value = _worst[i];
+
+        status->value = isfinite(value) ? value * rule->sign : NAN;
+
+        proc = i < _process_count ? _worst_proc[i] : NULL;
+        if (proc)
+          {
+             status->pid = proc->pid;
+             eina_strlcpy(status->command, proc->command, sizeof(status->command));
+          }
+
+        // NAN compares false both ways and leaves the state as is.
+        if (!status->active && value > rule->raise)
+          {
+             status->active = EINA_TRUE;
+             status->since = ecore_time_get();
+          }
+        else if (status->active && value <= rule->clear)
+          {
+             status->active = EINA_FALSE;
+          }
+        else
+          continue;
+
+        _hook_run(status);
+        changed++;
+     }
+
+   return changed;
+}
+
+Eina_Bool
+alert_process_io_used(void)
+{
+   for (int i = 0; i < _process_count; i++)
+     {
+        if (_rules[i].metric == ALERT_PROCESS_IO)
+          return EINA_TRUE;
+     }
+
+   return EINA_FALSE;
+}
+
+int
+alert_count(void)
+{
+   return _count;
+}
+
+const Alert_Status *
+alert_status_get(int index)
+{
+   if (index < 0 || index >= _count)
+     return NULL;
+
+   return &_status[index];
+}
@@ -0,0 +1,152 @@
+#ifndef __ALERT_H__
+#define __ALERT_H__
+
+/**
+ * @file
+ * @brief Threshold alerts over process snapshots and system statistics.
+ */
+
+/**
+ * @brief Alerts
+ * @defgroup Alert
+ *
+ * @{
+ *
+ * Rules are read once from $XDG_CONFIG_HOME/esysinfo/alerts.conf, or
+ * ~/.config/esysinfo/alerts.conf, one per line:
+ *
+ *   name: metric OP value [clear value]
+ *   hook command
+ *
+ * OP is > or <. An alert is raised when the metric crosses value and is
+ * only cleared once it is back past the clear value, which defaults to
+ * value. Metrics are:
+ *
+ *   process.cpu, process.rss, process.size, process.threads,
+ *   process.io, process.growth
+ *                     Raised by the worst process of a snapshot.
+ *   system.cpu, system.memory
+ *                     Usage in percent.
+ *   system.temperature
+ *                     CPU temperature in degrees Celsius.
+ *   system.zombies, system.processes
+ *                     Counted over a snapshot.
+ *   system.load       The 1 minute load average.
+ *   system.forks      Processes created per second.
+ *
+ * Memory values accept a K, M, G or T suffix. Lines starting with # are
+ * ignored, as are lines that can't be parsed.
+ *
+ * When an alert is raised or cleared, the hook command, if any, is run
+ * with ESYSINFO_ALERT_NAME, ESYSINFO_ALERT_STATE (raised or cleared),
+ * ESYSINFO_ALERT_VALUE, ESYSINFO_ALERT_PID and ESYSINFO_ALERT_COMMAND
+ * set in its environment.
+ *
+ * Rules are compiled to a flat array, process rules first, and a
+ * snapshot is evaluated in one pass over its processes.
+ *
+ */
+
+#include <Eina.h>
+#include "process.h"
+
+typedef enum
+{
+   ALERT_SYSTEM_CPU,
+   ALERT_SYSTEM_MEMORY,
+   ALERT_SYSTEM_TEMPERATURE,
+   ALERT_SYSTEM_ZOMBIES,
+   ALERT_SYSTEM_PROCESSES,
+   ALERT_SYSTEM_LOAD,
+   ALERT_SYSTEM_FORKS,
+   ALERT_SYSTEM_METRICS,
+} Alert_System_Metric;
+
+typedef struct _Alert_Status
+{
+   const char *name;
+   const char *metric;
+   // The value is in bytes.
+   Eina_Bool   memory;
+   Eina_Bool   active;
+   // When the alert was last raised, in ecore_time_get() seconds.
+   double      since;
+   // The last value seen, NAN if unknown.
+   double      value;
+   // The worst process, for process rules.
+   pid_t       pid;
+   char        command[CMD_NAME_MAX];
+} Alert_Status;
+
+/**
+ * Load the alert rules.
+ */
+void
+alert_init(void);
+
+/**
+ * Release the alert rules.
+ */
+void
+alert_shutdown(void);
+
+/**
+ * Set a system statistic, kept until it is set again.
+ *
+ * @param metric The statistic.
+ * @param value Its value, NAN if unknown.
+ */
+void
+alert_system_set(Alert_System_Metric metric, double value);
+
+/**
+ * Start evaluating a snapshot.
+ */
+void
+alert_begin(void);
+
+/**
+ * Evaluate the process rules against a process of the snapshot.
+ *
+ * @param proc The process, which must stay valid until alert_end().
+ */
+void
+alert_process(const Proc_Stats *proc);
+
+/**
+ * Finish evaluating a snapshot, evaluate the system rules and raise or
+ * clear alerts.
+ *
+ * @return The number of alerts that changed state.
+ */
+int
+alert_end(void);
+
+/**
+ * @return EINA_TRUE if a rule watches process.io, which needs per-process
+ *         I/O to be read.
+ */
+Eina_Bool
+alert_process_io_used(void);
+
+/**
+ * @return The number of rules.
+ */
+int
+alert_count(void);
+
+/**
+ * Get the status of a rule.
+ *
+ * @param index The rule, from 0 to alert_count() - 1.
+ *
+ * @return The status of the rule.
+ */
+const Alert_Status *
+alert_status_get(int index);
+
+/**
+ * @}
+ */
+
+#endif
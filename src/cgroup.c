@@ -0,0 +1,442 @@
+#include "cgroup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#if defined(__linux__)
+# include <dirent.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/stat.h>
+#endif
+
+// An interned path and the update it was last used in.
+typedef struct _Cgroup_Path
+{
+   unsigned int generation;
+   char         path[];
+} Cgroup_Path;
+
+static Eina_Hash   *_interned = NULL;
+static unsigned int _generation = 0;
+
+const char *
+cgroup_path_intern(const char *path)
+{
+   Cgroup_Path *interned;
+   size_t len;
+
+   if (!_interned)
+     _interned = eina_hash_string_superfast_new(free);
+
+   interned = eina_hash_find(_interned, path);
+   if (!interned)
+     {
+        len = strlen(path);
+        interned = malloc(sizeof(Cgroup_Path) + len + 1);
+        if (!interned) return NULL;
+
+        memcpy(interned->path, path, len + 1);
+        eina_hash_direct_add(_interned, interned->path, interned);
+     }
+
+   interned->generation = _generation;
+
+   return interned->path;
+}
+
+void
+cgroup_path_touch(const char *path)
+{
+   Cgroup_Path *interned = (Cgroup_Path *) (path - offsetof(Cgroup_Path, path));
+
+   interned->generation = _generation;
+}
+
+#if defined(__linux__)
+
+typedef struct _Cgroup_Node Cgroup_Node;
+
+static Eina_Bool
+_interned_stale_cb(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata)
+{
+   Cgroup_Path *interned = data;
+   Eina_List **stale = fdata;
+
+   if (interned->generation + 2 < _generation)
+     *stale = eina_list_append(*stale, key);
+
+   return EINA_TRUE;
+}
+
+// Free the paths not used in the last two updates, which leaves those of
+// the processes listed before this update valid until the next.
+static void
+_interned_sweep(void)
+{
+   Eina_List *stale = NULL;
+   const void *key;
+
+   if (!_interned) return;
+
+   eina_hash_foreach(_interned, _interned_stale_cb, &stale);
+
+   EINA_LIST_FREE(stale, key)
+     eina_hash_del_by_key(_interned, key);
+}
+
+struct _Cgroup_Node
+{
+   Cgroup          cgroup;
+   char           *name;
+   struct timespec mtime;
+   Eina_Bool       listed;
+   Eina_List      *children;
+
+   // Counters from the previous update.
+   double          time;
+   uint64_t        usage_usec;
+   uint64_t        nr_periods;
+   uint64_t        nr_throttled;
+};
+
+static char         _mount[PATH_MAX];
+static Eina_Bool    _mount_checked = EINA_FALSE;
+static Cgroup_Node *_root = NULL;
+static Eina_List   *_list = NULL;
+
+static Eina_Bool
+_mount_find(void)
+{
+   FILE *f;
+   char line[4096], mount[PATH_MAX], fstype[64];
+
+   if (_mount_checked)
+     return _mount[0] != '\0';
+
+   _mount_checked = EINA_TRUE;
+
+   f = fopen("/proc/self/mountinfo", "r");
+   if (!f) return EINA_FALSE;
+
+   // "36 25 0:31 / /sys/fs/cgroup rw,nosuid - cgroup2 cgroup2 rw"
+   while (fgets(line, sizeof(line), f))
+     {
+        char *sep = strstr(line, " - ");
+        if (!sep) continue;
+
+        if (sscanf(sep + 3, "%63s", fstype) != 1 || strcmp(fstype, "cgroup2"))
+          continue;
+
+        if (sscanf(line, "%*s %*s %*s %*s %4095s", mount) == 1)
+          {
+             eina_strlcpy(_mount, mount, sizeof(_mount));
+             break;
+          }
+     }
+
+   fclose(f);
+
+   return _mount[0] != '\0';
+}
+
+static ssize_t
+_file_read(const char *dir, const char *name, char *buf, size_t len)
+{
+   char path[PATH_MAX];
+   ssize_t bytes;
+   int fd;
+
+   snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+   fd = open(path, O_RDONLY | O_CLOEXEC);
+   if (fd < 0) return -1;
+
+   bytes = read(fd, buf, len - 1);
+   close(fd);
+
+   if (bytes < 0) return -1;
+   buf[bytes] = '\0';
+
+   return bytes;
+}
+
+static void
+_node_free(Cgroup_Node *node)
+{
+   Cgroup_Node *child;
+
+   EINA_LIST_FREE(node->children, child)
+     _node_free(child);
+
+   free(node->name);
+   free(node);
+}
+
+static Cgroup_Node *
+_node_new(const char *name, const char *path, int depth)
+{
+   Cgroup_Node *node;
+
+   node = calloc(1, sizeof(Cgroup_Node));
+   if (!node) return NULL;
+
+   node->name = strdup(name);
+   node->cgroup.path = cgroup_path_intern(path);
+   node->cgroup.depth = depth;
+
+   if (!node->cgroup.path)
+     {
+        free(node->name);
+        free(node);
+        return NULL;
+     }
+
+   return node;
+}
+
+static void
+_node_stats_read(Cgroup_Node *node, const char *dir, double now)
+{
+   Cgroup *cg = &node->cgroup;
+   char buf[1024], *p;
+   unsigned long long value;
+   double elapsed;
+
+   cg->usage_usec = cg->nr_periods = cg->nr_throttled = cg->throttled_usec = 0;
+   cg->memory_current = 0;
+   cg->memory_max = -1;
+   cg->memory_some = cg->memory_full = -1;
+   cg->cpu_some = cg->io_some = -1;
+
+   if (_file_read(dir, "cpu.stat", buf, sizeof(buf)) > 0)
+     {
+        for (p = buf; p && *p; p = strchr(p, '\n'), p = p ? p + 1 : NULL)
+          {
+             if (sscanf(p, "usage_usec %llu", &value) == 1)
+               cg->usage_usec = value;
+             else if (sscanf(p, "nr_periods %llu", &value) == 1)
+               cg->nr_periods = value;
+             else if (sscanf(p, "nr_throttled %llu", &value) == 1)
+               cg->nr_throttled = value;
+             else if (sscanf(p, "throttled_usec %llu", &value) == 1)
+               cg->throttled_usec = value;
+          }
+     }
+
+   if (_file_read(dir, "memory.current", buf, sizeof(buf)) > 0)
+     cg->memory_current = strtoll(buf, NULL, 10);
+
+   if (_file_read(dir, "memory.max", buf, sizeof(buf)) > 0 && strncmp(buf, "max", 3))
+     cg->memory_max = strtoll(buf, NULL, 10);
+
+   if (_file_read(dir, "memory.pressure", buf, sizeof(buf)) > 0)
+     {
+        p = strstr(buf, "some avg10=");
+        if (p) cg->memory_some = atof(p + 11);
+        p = strstr(buf, "full avg10=");
+        if (p) cg->memory_full = atof(p + 11);
+     }
+
+   if (_file_read(dir, "cpu.pressure", buf, sizeof(buf)) > 0)
+     {
+        p = strstr(buf, "some avg10=");
+        if (p) cg->cpu_some = atof(p + 11);
+     }
+
+   if (_file_read(dir, "io.pressure", buf, sizeof(buf)) > 0)
+     {
+        p = strstr(buf, "some avg10=");
+        if (p) cg->io_some = atof(p + 11);
+     }
+
+   cg->cpu_usage = cg->throttled = 0;
+
+   elapsed = now - node->time;
+   if (node->time && elapsed > 0)
+     {
+        if (cg->usage_usec > node->usage_usec)
+          cg->cpu_usage = (cg->usage_usec - node->usage_usec) / 10000.0 / elapsed;
+        if (cg->nr_periods > node->nr_periods && cg->nr_throttled >= node->nr_throttled)
+          cg->throttled = (cg->nr_throttled - node->nr_throttled) * 100.0 / (cg->nr_periods - node->nr_periods);
+     }
+
+   node->time = now;
+   node->usage_usec = cg->usage_usec;
+   node->nr_periods = cg->nr_periods;
+   node->nr_throttled = cg->nr_throttled;
+}
+
+static Cgroup_Node *
+_node_child_find(Cgroup_Node *node, const char *name)
+{
+   Eina_List *l;
+   Cgroup_Node *child;
+
+   EINA_LIST_FOREACH(node->children, l, child)
+     {
+        if (!strcmp(child->name, name))
+          return child;
+     }
+
+   return NULL;
+}
+
+static int
+_node_name_cmp(const void *a, const void *b)
+{
+   const Cgroup_Node *one = a, *two = b;
+
+   return strcmp(one->name, two->name);
+}
+
+// List the children of a group again, keeping those that still exist.
+static void
+_node_list(Cgroup_Node *node, const char *dir)
+{
+   DIR *d;
+   struct dirent *dh;
+   struct stat st;
+   Eina_List *children = NULL;
+   Cgroup_Node *child;
+   char path[PATH_MAX];
+
+   d = opendir(dir);
+   if (!d) return;
+
+   while ((dh = readdir(d)))
+     {
+        if (dh->d_name[0] == '.')
+          continue;
+
+        if (dh->d_type != DT_DIR)
+          {
+             if (dh->d_type != DT_UNKNOWN)
+               continue;
+             if (fstatat(dirfd(d), dh->d_name, &st, AT_SYMLINK_NOFOLLOW) < 0 || !S_ISDIR(st.st_mode))
+               continue;
+          }
+
+        child = _node_child_find(node, dh->d_name);
+        if (child)
+          node->children = eina_list_remove(node->children, child);
+        else
+          {
+             if (node->cgroup.depth)
+               snprintf(path, sizeof(path), "%s/%s", node->cgroup.path, dh->d_name);
+             else
+               snprintf(path, sizeof(path), "/%s", dh->d_name);
+
+             child = _node_new(dh->d_name, path, node->cgroup.depth + 1);
+             if (!child) continue;
+          }
+
+        children = eina_list_append(children, child);
+     }
+
+   closedir(d);
+
+   // Whatever is left has been removed.
+   EINA_LIST_FREE(node->children, child)
+     _node_free(child);
+
+   node->children = eina_list_sort(children, eina_list_count(children), _node_name_cmp);
+}
+
+static Eina_Bool
+_node_update(Cgroup_Node *node, const char *dir, double now)
+{
+   struct stat st;
+   Eina_List *l, *l_next;
+   Cgroup_Node *child;
+   char path[PATH_MAX];
+
+   if (stat(dir, &st) < 0)
+     return EINA_FALSE;
+
+   if (!node->listed ||
+       st.st_mtim.tv_sec != node->mtime.tv_sec || st.st_mtim.tv_nsec != node->mtime.tv_nsec)
+     {
+        _node_list(node, dir);
+        node->mtime = st.st_mtim;
+        node->listed = EINA_TRUE;
+     }
+
+   cgroup_path_touch(node->cgroup.path);
+   _node_stats_read(node, dir, now);
+   _list = eina_list_append(_list, &node->cgroup);
+
+   EINA_LIST_FOREACH_SAFE(node->children, l, l_next, child)
+     {
+        snprintf(path, sizeof(path), "%s/%s", dir, child->name);
+        if (!_node_update(child, path, now))
+          {
+             // Removed since it was listed.
+             node->children = eina_list_remove_list(node->children, l);
+             _node_free(child);
+          }
+     }
+
+   return EINA_TRUE;
+}
+
+const Eina_List *
+cgroup_update(void)
+{
+   struct timespec ts;
+   double now;
+
+   _list = eina_list_free(_list);
+
+   if (!_mount_find())
+     return NULL;
+
+   _generation++;
+
+   if (!_root)
+     {
+        _root = _node_new("", "/", 0);
+        if (!_root) return NULL;
+     }
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   now = ts.tv_sec + ts.tv_nsec / 1000000000.0;
+
+   if (!_node_update(_root, _mount, now))
+     {
+        _node_free(_root);
+        _root = NULL;
+     }
+
+   _interned_sweep();
+
+   return _list;
+}
+
+void
+cgroup_shutdown(void)
+{
+   _list = eina_list_free(_list);
+
+   if (_root)
+     _node_free(_root);
+   _root = NULL;
+}
+
+#else
+
+const Eina_List *
+cgroup_update(void)
+{
+   return NULL;
+}
+
+void
+cgroup_shutdown(void)
+{
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef __CGROUP_H__
+#define __CGROUP_H__
+
+/**
+ * @file
+ * @brief Control group (cgroup v2) statistics.
+ */
+
+/**
+ * @brief Control Groups
+ * @defgroup Cgroup
+ *
+ * @{
+ *
+ * Walk the cgroup v2 hierarchy and read each group's own accounting from
+ * cgroupfs: cpu.stat, memory.current, memory.max and the cpu, memory
+ * and io pressure files.
+ * These already cover every process below a group, nothing is summed.
+ *
+ * The tree is kept between updates. A directory is only listed again
+ * when its modification time changes, which is when a child group is
+ * created or removed.
+ *
+ * Group paths are relative to the cgroup2 mount and interned, so two
+ * paths are the same group when the pointers are equal.
+ *
+ */
+
+#include <Eina.h>
+#include <stdint.h>
+
+typedef struct _Cgroup
+{
+   // Interned, "/" for the root group.
+   const char *path;
+   int         depth;
+
+   uint64_t    usage_usec;
+   uint64_t    nr_periods;
+   uint64_t    nr_throttled;
+   uint64_t    throttled_usec;
+
+   int64_t     memory_current;
+   // -1 when unlimited.
+   int64_t     memory_max;
+
+   // Share of the last 10 seconds some or all tasks stalled on memory,
+   // in percent. -1 when unavailable.
+   double      memory_some;
+   double      memory_full;
+   // The same for CPU and I/O, "some" only.
+   double      cpu_some;
+   double      io_some;
+
+   // Since the previous update: CPU % of one CPU and percent of
+   // enforcement periods that were throttled.
+   double      cpu_usage;
+   double      throttled;
+} Cgroup;
+
+/**
+ * Intern a cgroup path. cgroup_update() frees paths that were neither
+ * interned nor touched during its last two calls.
+ *
+ * @param path The path, relative to the cgroup2 mount.
+ *
+ * @return The interned path, or NULL when out of memory.
+ */
+const char *
+cgroup_path_intern(const char *path);
+
+/**
+ * Mark an interned path as still in use.
+ *
+ * @param path A path returned by cgroup_path_intern().
+ */
+void
+cgroup_path_touch(const char *path);
+
+/**
+ * Walk the hierarchy and read the statistics of every group.
+ *
+ * @return The groups in pre-order, owned by the module and valid until
+ *         the next update or cgroup_shutdown(). NULL without cgroup v2.
+ */
+const Eina_List *
+cgroup_update(void);
+
+/**
+ * Release the hierarchy.
+ */
+void
+cgroup_shutdown(void);
+
+/**
+ * @}
+ */
+
+#endif
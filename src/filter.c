@@ -0,0 +1,331 @@
+#include "filter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <sys/types.h>
+#include <regex.h>
+
+typedef enum
+{
+   TERM_COMMAND,
+   TERM_REGEX,
+   TERM_UID,
+   TERM_USER,
+   TERM_STATE,
+   TERM_COMPARE,
+} Term_Type;
+
+typedef enum
+{
+   FIELD_PID,
+   FIELD_RSS,
+   FIELD_SIZE,
+   FIELD_CPU,
+   FIELD_THREADS,
+} Term_Field;
+
+typedef enum
+{
+   OP_LT,
+   OP_LE,
+   OP_EQ,
+   OP_GE,
+   OP_GT,
+} Term_Op;
+
+typedef struct _Term
+{
+   Term_Type  type;
+   Term_Field field;
+   Term_Op    op;
+   double     value;
+   char      *text;
+   regex_t    regex;
+} Term;
+
+struct _Filter
+{
+   int  count;
+   Term terms[];
+};
+
+static const struct
+{
+   const char *name;
+   Term_Field  field;
+   Eina_Bool   memory;
+} _fields[] = {
+   { "pid", FIELD_PID, EINA_FALSE },
+   { "rss", FIELD_RSS, EINA_TRUE },
+   { "size", FIELD_SIZE, EINA_TRUE },
+   { "cpu", FIELD_CPU, EINA_FALSE },
+   { "threads", FIELD_THREADS, EINA_FALSE },
+};
+
+static void
+_term_command_set(Term *term, const char *text)
+{
+   term->type = TERM_COMMAND;
+   term->text = strdup(text);
+
+   for (char *p = term->text; *p; p++)
+     *p = tolower((unsigned char) *p);
+}
+
+static Eina_Bool
+_term_compare_parse(Term *term, const char *token)
+{
+   const char *p;
+   char *end;
+   double value, scale = 1;
+   size_t len;
+   int i, count;
+
+   len = strcspn(token, "<>=");
+   if (!len || !token[len])
+     return EINA_FALSE;
+
+   count = sizeof(_fields) / sizeof(_fields[0]);
+   for (i = 0; i < count; i++)
+     {
+        if (strlen(_fields[i].name) == len && !strncasecmp(_fields[i].name, token, len))
+          break;
+     }
+
+   if (i == count)
+     return EINA_FALSE;
+
+   p = token + len;
+   if (p[0] == '<' && p[1] == '=')
+     { term->op = OP_LE; p += 2; }
+   else if (p[0] == '>' && p[1] == '=')
+     { term->op = OP_GE; p += 2; }
+   else if (p[0] == '<')
+     { term->op = OP_LT; p++; }
+   else if (p[0] == '>')
+     { term->op = OP_GT; p++; }
+   else if (p[0] == '=')
+     {
+        term->op = OP_EQ; p++;
+        if (*p == '=') p++;
+     }
+
+   value = strtod(p, &end);
+   if (end == p)
+     return EINA_FALSE;
+
+   if (_fields[i].memory)
+     {
+        switch (toupper((unsigned char) *end))
+          {
+           case 'T':
+             scale *= 1024;
+           /* fallthrough */
+           case 'G':
+             scale *= 1024;
+           /* fallthrough */
+           case 'M':
+             scale *= 1024;
+           /* fallthrough */
+           case 'K':
+             scale *= 1024;
+             end++;
+             break;
+          }
+        if (toupper((unsigned char) *end) == 'B')
+          end++;
+     }
+
+   if (*end)
+     return EINA_FALSE;
+
+   term->type = TERM_COMPARE;
+   term->field = _fields[i].field;
+   term->value = value * scale;
+
+   return EINA_TRUE;
+}
+
+static void
+_term_parse(Term *term, const char *token)
+{
+   size_t len = strlen(token);
+
+   if (len > 1 && token[0] == '/')
+     {
+        char *pattern = strdup(token + 1);
+
+        if (pattern[len - 2] == '/')
+          pattern[len - 2] = '\0';
+
+        if (pattern[0] && !regcomp(&term->regex, pattern, REG_EXTENDED | REG_ICASE | REG_NOSUB))
+          {
+             term->type = TERM_REGEX;
+             term->text = pattern;
+          }
+        else
+          {
+             // Incomplete while typing, fall back to a plain substring.
+             _term_command_set(term, pattern);
+             free(pattern);
+          }
+     }
+   else if (!strncasecmp(token, "uid:", 4))
+     {
+        term->type = TERM_UID;
+        term->value = atol(token + 4);
+     }
+   else if (!strncasecmp(token, "user:", 5))
+     {
+        term->type = TERM_USER;
+        term->text = strdup(token + 5);
+     }
+   else if (!strncasecmp(token, "state:", 6))
+     {
+        term->type = TERM_STATE;
+        term->text = strdup(token + 6);
+     }
+   else if (!_term_compare_parse(term, token))
+     {
+        _term_command_set(term, token);
+     }
+}
+
+Filter *
+filter_new(const char *text)
+{
+   Filter *filter;
+   char *copy, *token, *saveptr = NULL;
+   int count = 0;
+
+   if (!text)
+     return NULL;
+
+   copy = strdup(text);
+   if (!copy) return NULL;
+
+   for (token = strtok_r(copy, " \t", &saveptr); token; token = strtok_r(NULL, " \t", &saveptr))
+     count++;
+
+   if (!count)
+     {
+        free(copy);
+        return NULL;
+     }
+
+   filter = calloc(1, sizeof(Filter) + count * sizeof(Term));
+   if (!filter)
+     {
+        free(copy);
+        return NULL;
+     }
+
+   strcpy(copy, text);
+
+   for (token = strtok_r(copy, " \t", &saveptr); token; token = strtok_r(NULL, " \t", &saveptr))
+     _term_parse(&filter->terms[filter->count++], token);
+
+   free(copy);
+
+   return filter;
+}
+
+void
+filter_free(Filter *filter)
+{
+   if (!filter) return;
+
+   for (int i = 0; i < filter->count; i++)
+     {
+        Term *term = &filter->terms[i];
+        if (term->type == TERM_REGEX)
+          regfree(&term->regex);
+        free(term->text);
+     }
+
+   free(filter);
+}
+
+static double
+_field_value(const Proc_Stats *proc, Term_Field field)
+{
+   switch (field)
+     {
+      case FIELD_PID:
+        return proc->pid;
+
+      case FIELD_RSS:
+        return proc->mem_rss;
+
+      case FIELD_SIZE:
+        return proc->mem_size;
+
+      case FIELD_CPU:
+        return proc->cpu_usage;
+
+      case FIELD_THREADS:
+        return proc->numthreads;
+     }
+
+   return 0;
+}
+
+static Eina_Bool
+_term_match(const Term *term, const Proc_Stats *proc, const char *command_lower)
+{
+   double value;
+
+   switch (term->type)
+     {
+      case TERM_COMMAND:
+        return strstr(command_lower, term->text) != NULL;
+
+      case TERM_REGEX:
+        return !regexec(&term->regex, proc->command, 0, NULL, 0);
+
+      case TERM_UID:
+        return proc->uid == (uid_t) term->value;
+
+      case TERM_USER:
+        return proc->user && !strcmp(proc->user, term->text);
+
+      case TERM_STATE:
+        return proc->state && !strcasecmp(proc->state, term->text);
+
+      case TERM_COMPARE:
+        value = _field_value(proc, term->field);
+        switch (term->op)
+          {
+           case OP_LT:
+             return value < term->value;
+
+           case OP_LE:
+             return value <= term->value;
+
+           case OP_EQ:
+             return value == term->value;
+
+           case OP_GE:
+             return value >= term->value;
+
+           case OP_GT:
+             return value > term->value;
+          }
+     }
+
+   return EINA_FALSE;
+}
+
+Eina_Bool
+filter_match(const Filter *filter, const Proc_Stats *proc, const char *command_lower)
+{
+   for (int i = 0; i < filter->count; i++)
+     {
+        if (!_term_match(&filter->terms[i], proc, command_lower))
+          return EINA_FALSE;
+     }
+
+   return EINA_TRUE;
+}
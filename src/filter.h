@@ -0,0 +1,69 @@
+#ifndef __FILTER_H__
+#define __FILTER_H__
+
+/**
+ * @file
+ * @brief Filtering of process snapshots.
+ */
+
+/**
+ * @brief Process Filters
+ * @defgroup Filter
+ *
+ * @{
+ *
+ * Compile a search string into a filter that can be matched against
+ * a process. A search string is made up of whitespace separated terms
+ * which must all match:
+ *
+ *   text          Command contains text (case insensitive).
+ *   /regex/       Command matches an extended regular expression.
+ *   uid:N         Process UID is N.
+ *   user:name     Process is owned by user name.
+ *   state:name    Process state is name (RUN, SLEEP, ZOMB...).
+ *   field OP N    Numeric comparison, OP is one of < <= = >= >.
+ *                 Fields are pid, rss, size, cpu and threads. Memory
+ *                 values accept a K, M, G or T suffix.
+ *
+ */
+
+#include <Eina.h>
+#include "process.h"
+
+typedef struct _Filter Filter;
+
+/**
+ * Compile a search string.
+ *
+ * @param text The search string.
+ *
+ * @return A compiled filter or NULL if the search string is empty.
+ */
+Filter *
+filter_new(const char *text);
+
+/**
+ * Free a compiled filter.
+ *
+ * @param filter The filter to free.
+ */
+void
+filter_free(Filter *filter);
+
+/**
+ * Match a process against a compiled filter.
+ *
+ * @param filter The compiled filter.
+ * @param proc The process to test.
+ * @param command_lower The process command in lower case.
+ *
+ * @return EINA_TRUE if every term of the filter matches.
+ */
+Eina_Bool
+filter_match(const Filter *filter, const Proc_Stats *proc, const char *command_lower);
+
+/**
+ * @}
+ */
+
+#endif
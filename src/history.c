@@ -0,0 +1,350 @@
+#include "history.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HISTORY_SLOTS (HISTORY_FINE_SAMPLES + HISTORY_MEDIUM_SAMPLES + HISTORY_COARSE_SAMPLES)
+
+// Blocks are allocated this many at a time.
+#define HISTORY_SLAB_COUNT 64
+
+static const struct
+{
+   int seconds;
+   int samples;
+   int offset;
+} _tiers[HISTORY_TIERS] = {
+   { 0, HISTORY_FINE_SAMPLES, 0 },
+   { HISTORY_MEDIUM_SECONDS, HISTORY_MEDIUM_SAMPLES, HISTORY_FINE_SAMPLES },
+   { HISTORY_COARSE_SECONDS, HISTORY_COARSE_SAMPLES, HISTORY_FINE_SAMPLES + HISTORY_MEDIUM_SAMPLES },
+};
+
+// A rollup bucket in progress.
+typedef struct _History_Bucket
+{
+   long long slot;
+   int       count;
+   float     min[HISTORY_METRICS];
+   float     max[HISTORY_METRICS];
+   double    sum[HISTORY_METRICS];
+} History_Bucket;
+
+// Least squares fit of resident memory over the medium ring. x is the
+// bucket number since the history started, kept to drop points exactly.
+typedef struct _History_Trend
+{
+   long long origin;
+   int       x[HISTORY_MEDIUM_SAMPLES];
+   double    n, sum_x, sum_y, sum_xy, sum_xx;
+} History_Trend;
+
+typedef struct _History History;
+
+struct _History
+{
+   pid_t              pid;
+   unsigned long long start_time;
+   unsigned int       generation;
+   History           *next_free;
+
+   int                head[HISTORY_TIERS];
+   int                count[HISTORY_TIERS];
+   History_Bucket     bucket[HISTORY_TIERS];
+   History_Trend      trend;
+   History_Point      points[HISTORY_SLOTS][HISTORY_METRICS];
+};
+
+static Eina_Hash   *_histories = NULL;
+static Eina_List   *_slabs = NULL;
+static History     *_free = NULL;
+static unsigned int _generation = 0;
+
+static History *
+_history_alloc(void)
+{
+   History *slab, *h;
+
+   if (!_free)
+     {
+        slab = malloc(HISTORY_SLAB_COUNT * sizeof(History));
+        if (!slab) return NULL;
+
+        _slabs = eina_list_append(_slabs, slab);
+
+        for (int i = 0; i < HISTORY_SLAB_COUNT; i++)
+          {
+             slab[i].next_free = _free;
+             _free = &slab[i];
+          }
+     }
+
+   h = _free;
+   _free = h->next_free;
+
+   return h;
+}
+
+static void
+_history_release(void *data)
+{
+   History *h = data;
+
+   h->next_free = _free;
+   _free = h;
+}
+
+static void
+_history_reset(History *h, pid_t pid, unsigned long long start_time)
+{
+   h->pid = pid;
+   h->start_time = start_time;
+   h->next_free = NULL;
+
+   memset(h->head, 0, sizeof(h->head));
+   memset(h->count, 0, sizeof(h->count));
+   memset(h->bucket, 0, sizeof(h->bucket));
+   memset(&h->trend, 0, sizeof(h->trend));
+}
+
+static void
+_trend_update(History *h, long long slot, double y)
+{
+   History_Trend *t = &h->trend;
+   double x, old;
+   int i = h->head[HISTORY_TIER_MEDIUM];
+
+   // The ring is full, the point about to be overwritten leaves the window.
+   if (h->count[HISTORY_TIER_MEDIUM] == HISTORY_MEDIUM_SAMPLES)
+     {
+        x = t->x[i];
+        old = h->points[_tiers[HISTORY_TIER_MEDIUM].offset + i][HISTORY_RSS].avg;
+
+        t->n--;
+        t->sum_x -= x;
+        t->sum_y -= old;
+        t->sum_xy -= x * old;
+        t->sum_xx -= x * x;
+     }
+
+   if (!t->n)
+     {
+        t->origin = slot;
+        t->sum_x = t->sum_y = t->sum_xy = t->sum_xx = 0;
+     }
+
+   t->x[i] = x = slot - t->origin;
+
+   t->n++;
+   t->sum_x += x;
+   t->sum_y += y;
+   t->sum_xy += x * y;
+   t->sum_xx += x * x;
+}
+
+static void
+_history_push(History *h, History_Tier tier, const History_Point point[HISTORY_METRICS])
+{
+   History_Point *slot;
+
+   slot = h->points[_tiers[tier].offset + h->head[tier]];
+   memcpy(slot, point, HISTORY_METRICS * sizeof(History_Point));
+
+   h->head[tier] = (h->head[tier] + 1) % _tiers[tier].samples;
+   if (h->count[tier] < _tiers[tier].samples)
+     h->count[tier]++;
+}
+
+static void
+_bucket_point(const History_Bucket *bucket, History_Point point[HISTORY_METRICS])
+{
+   for (int m = 0; m < HISTORY_METRICS; m++)
+     {
+        point[m].min = bucket->min[m];
+        point[m].max = bucket->max[m];
+        point[m].avg = bucket->sum[m] / bucket->count;
+     }
+}
+
+void
+history_init(void)
+{
+   if (_histories) return;
+
+   _histories = eina_hash_int32_new(_history_release);
+}
+
+void
+history_shutdown(void)
+{
+   void *slab;
+
+   if (!_histories) return;
+
+   eina_hash_free(_histories);
+   _histories = NULL;
+
+   EINA_LIST_FREE(_slabs, slab)
+     free(slab);
+
+   _free = NULL;
+}
+
+void
+history_begin(void)
+{
+   _generation++;
+}
+
+void
+history_add(pid_t pid, unsigned long long start_time, double time, const float values[HISTORY_METRICS])
+{
+   History *h;
+   History_Bucket *bucket;
+   History_Point point[HISTORY_METRICS];
+   long long slot;
+   int m;
+
+   if (!_histories) return;
+
+   h = eina_hash_find(_histories, &pid);
+   if (!h)
+     {
+        h = _history_alloc();
+        if (!h) return;
+
+        _history_reset(h, pid, start_time);
+        eina_hash_add(_histories, &pid, h);
+     }
+   else if (h->start_time != start_time)
+     {
+        _history_reset(h, pid, start_time);
+     }
+
+   h->generation = _generation;
+
+   for (m = 0; m < HISTORY_METRICS; m++)
+     point[m].min = point[m].avg = point[m].max = values[m];
+
+   _history_push(h, HISTORY_TIER_FINE, point);
+
+   for (int tier = HISTORY_TIER_FINE + 1; tier < HISTORY_TIERS; tier++)
+     {
+        bucket = &h->bucket[tier];
+        slot = time / _tiers[tier].seconds;
+
+        if (bucket->count && bucket->slot != slot)
+          {
+             _bucket_point(bucket, point);
+             if (tier == HISTORY_TIER_MEDIUM)
+               _trend_update(h, bucket->slot, point[HISTORY_RSS].avg);
+             _history_push(h, tier, point);
+             bucket->count = 0;
+          }
+
+        for (m = 0; m < HISTORY_METRICS; m++)
+          {
+             if (!bucket->count)
+               {
+                  bucket->min[m] = bucket->max[m] = values[m];
+                  bucket->sum[m] = 0;
+               }
+             if (values[m] < bucket->min[m]) bucket->min[m] = values[m];
+             if (values[m] > bucket->max[m]) bucket->max[m] = values[m];
+             bucket->sum[m] += values[m];
+          }
+
+        bucket->slot = slot;
+        bucket->count++;
+     }
+}
+
+static Eina_Bool
+_history_stale_cb(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata)
+{
+   History *h = data;
+   Eina_List **stale = fdata;
+
+   if (h->generation != _generation)
+     *stale = eina_list_append(*stale, key);
+
+   return EINA_TRUE;
+}
+
+void
+history_end(void)
+{
+   Eina_List *stale = NULL;
+   const void *key;
+
+   if (!_histories) return;
+
+   eina_hash_foreach(_histories, _history_stale_cb, &stale);
+
+   EINA_LIST_FREE(stale, key)
+     eina_hash_del_by_key(_histories, key);
+}
+
+int
+history_get(pid_t pid, unsigned long long start_time, History_Tier tier, History_Metric metric,
+            History_Point *points, int max)
+{
+   History *h;
+   History_Point current[HISTORY_METRICS];
+   int i, n, start, pending;
+
+   if (!_histories || max <= 0) return 0;
+
+   h = eina_hash_find(_histories, &pid);
+   if (!h || h->start_time != start_time)
+     return 0;
+
+   pending = (tier != HISTORY_TIER_FINE && h->bucket[tier].count) ? 1 : 0;
+
+   n = h->count[tier];
+   if (n + pending > max)
+     n = max - pending;
+
+   start = (h->head[tier] - n + _tiers[tier].samples) % _tiers[tier].samples;
+   for (i = 0; i < n; i++)
+     points[i] = h->points[_tiers[tier].offset + (start + i) % _tiers[tier].samples][metric];
+
+   if (pending)
+     {
+        _bucket_point(&h->bucket[tier], current);
+        points[n++] = current[metric];
+     }
+
+   return n;
+}
+
+Eina_Bool
+history_rss_growth_get(pid_t pid, unsigned long long start_time, double *growth)
+{
+   History *h;
+   History_Trend *t;
+   double d;
+
+   if (!_histories) return EINA_FALSE;
+
+   h = eina_hash_find(_histories, &pid);
+   if (!h || h->start_time != start_time)
+     return EINA_FALSE;
+
+   t = &h->trend;
+   if (t->n < HISTORY_GROWTH_MIN_SAMPLES)
+     return EINA_FALSE;
+
+   d = t->n * t->sum_xx - t->sum_x * t->sum_x;
+   if (d <= 0)
+     return EINA_FALSE;
+
+   // Bytes per bucket, scaled to bytes per hour.
+   *growth = (t->n * t->sum_xy - t->sum_x * t->sum_y) / d * (3600 / HISTORY_MEDIUM_SECONDS);
+
+   return EINA_TRUE;
+}
+
+size_t
+history_process_size(void)
+{
+   return sizeof(History);
+}
@@ -0,0 +1,145 @@
+#ifndef __HISTORY_H__
+#define __HISTORY_H__
+
+/**
+ * @file
+ * @brief Per-process history of CPU, memory and disk I/O.
+ */
+
+/**
+ * @brief Process History
+ * @defgroup History
+ *
+ * @{
+ *
+ * Keep a fixed size history for every live process. Each poll is kept
+ * as is in a fine ring, and rolled up into coarser min/avg/max rings:
+ *
+ *   HISTORY_TIER_FINE    Every poll, HISTORY_FINE_SAMPLES of them.
+ *   HISTORY_TIER_MEDIUM  10 second buckets covering an hour.
+ *   HISTORY_TIER_COARSE  1 minute buckets covering a day.
+ *
+ * The resident memory of each process is also fitted to a line over the
+ * medium ring, a least squares fit kept up to date with running sums as
+ * buckets are added and dropped, to spot slow leaks.
+ *
+ * All rings of a process live in one History block of a known size,
+ * allocated from a slab and looked up by pid. A pid whose start time
+ * changes gets a fresh history, and blocks of processes that were not
+ * seen by a poll are returned to the slab.
+ *
+ */
+
+#include <Eina.h>
+#include <sys/types.h>
+
+typedef enum
+{
+   HISTORY_CPU,
+   HISTORY_RSS,
+   HISTORY_IO,
+   HISTORY_METRICS,
+} History_Metric;
+
+typedef enum
+{
+   HISTORY_TIER_FINE,
+   HISTORY_TIER_MEDIUM,
+   HISTORY_TIER_COARSE,
+   HISTORY_TIERS,
+} History_Tier;
+
+#define HISTORY_FINE_SAMPLES   120
+#define HISTORY_MEDIUM_SECONDS 10
+#define HISTORY_MEDIUM_SAMPLES 360
+#define HISTORY_COARSE_SECONDS 60
+#define HISTORY_COARSE_SAMPLES 1440
+
+// Medium buckets needed before the memory growth is known, 5 minutes.
+#define HISTORY_GROWTH_MIN_SAMPLES 30
+
+typedef struct _History_Point
+{
+   float min;
+   float avg;
+   float max;
+} History_Point;
+
+/**
+ * Initialize the history store.
+ */
+void
+history_init(void);
+
+/**
+ * Release the history store.
+ */
+void
+history_shutdown(void);
+
+/**
+ * Start recording a poll.
+ */
+void
+history_begin(void);
+
+/**
+ * Record the values of a process.
+ *
+ * @param pid The process ID.
+ * @param start_time The start time of the process.
+ * @param time The CLOCK_MONOTONIC time of the values in seconds.
+ * @param values CPU %, resident memory in bytes and disk I/O in bytes
+ *               per second, indexed by History_Metric.
+ */
+void
+history_add(pid_t pid, unsigned long long start_time, double time,
+            const float values[HISTORY_METRICS]);
+
+/**
+ * Finish recording a poll and release the history of every process that
+ * was not recorded since history_begin().
+ */
+void
+history_end(void);
+
+/**
+ * Get the most recent history of a process, oldest first. The coarser
+ * tiers include their bucket in progress as the last point.
+ *
+ * @param pid The process ID.
+ * @param start_time The start time of the process.
+ * @param tier The resolution to read.
+ * @param metric The value to read.
+ * @param points Where to store the points.
+ * @param max The number of points that fit in points.
+ *
+ * @return The number of points stored.
+ */
+int
+history_get(pid_t pid, unsigned long long start_time, History_Tier tier, History_Metric metric,
+            History_Point *points, int max);
+
+/**
+ * Get how fast the resident memory of a process grows.
+ *
+ * @param pid The process ID.
+ * @param start_time The start time of the process.
+ * @param growth Where to store the growth in bytes per hour.
+ *
+ * @return EINA_FALSE if there is not enough history yet.
+ */
+Eina_Bool
+history_rss_growth_get(pid_t pid, unsigned long long start_time, double *growth);
+
+/**
+ * @return The number of bytes of history kept for each process.
+ */
+size_t
+history_process_size(void);
+
+/**
+ * @}
+ */
+
+#endif
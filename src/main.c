@@ -5,6 +5,11 @@
 #include "process.h"
 #include "system.h"
 #include "ui.h"
+#include "users.h"
+#include "watch.h"
+#include "history.h"
+#include "alert.h"
+#include "cgroup.h"
 
 static void
 _win_del_cb(void *data EINA_UNUSED, Evas_Object *obj, void *event_info EINA_UNUSED)
@@ -42,6 +47,11 @@ main(int argc, char **argv)
    ecore_init();
    elm_init(argc, argv);
 
+   users_init();
+   watch_init();
+   history_init();
+   alert_init();
+
    win = _win_add();
    ui_add(win);
 
@@ -50,6 +60,12 @@ main(int argc, char **argv)
 
    ecore_main_loop_begin();
 
+   cgroup_shutdown();
+   alert_shutdown();
+   history_shutdown();
+   watch_shutdown();
+   users_shutdown();
+
    eina_shutdown();
    ecore_shutdown();
    elm_shutdown();
@@ -28,8 +28,21 @@
 #include <ctype.h>
 #include <unistd.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stddef.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#if defined(__linux__)
+# include <dirent.h>
+# include <netinet/in.h>
+# include <arpa/inet.h>
+#endif
 
 #include "process.h"
+#include "cgroup.h"
 #include <Eina.h>
 #include <Ecore.h>
 #include <Ecore_File.h>
@@ -120,8 +133,570 @@ _process_state_name(char state)
    return statename;
 }
 
+static unsigned int _flags = PROC_INFO_FLAG_NONE;
+// Bumped when cgroups start being read, to read every process's again.
+static unsigned int _cgroup_epoch = 0;
+
+#if defined(__linux__)
+static void _proc_cache_dirs_close(void);
+#endif
+
+static double
+_proc_timestamp(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+void
+proc_info_flags_set(unsigned int flags)
+{
+   if ((flags & PROC_INFO_FLAG_CGROUP) && !(_flags & PROC_INFO_FLAG_CGROUP))
+     _cgroup_epoch++;
+
+#if defined(__linux__)
+   if (!(flags & PROC_INFO_FLAG_NS) && (_flags & PROC_INFO_FLAG_NS))
+     _proc_cache_dirs_close();
+#endif
+
+   _flags = flags;
+}
+
 #if defined(__linux__)
 
+#define FD_DENIED -2
+
+// Files under /proc/<pid> that are read on every poll are kept open and
+// re-read with pread(). The cache is swept after each full scan.
+typedef struct _Proc_Cache
+{
+   pid_t              pid;
+   unsigned long long start_time;
+   unsigned int       generation;
+   int                io_fd;
+   int                sched_fd;
+   int                smaps_fd;
+   // /proc/<pid>, namespaces are looked up relative to it.
+   int                dir_fd;
+
+   // Processes rarely move, so this is only read again now and then.
+   const char        *cgroup;
+   double             cgroup_time;
+   unsigned int       cgroup_epoch;
+   // The last namespaces seen, checked again on every poll.
+   const Proc_Namespaces *ns;
+
+   double             smaps_time;
+   Eina_Bool          smaps_valid;
+   int64_t            mem_pss;
+   int64_t            mem_uss;
+   int64_t            mem_swap;
+   int64_t            mem_anon_huge;
+} Proc_Cache;
+
+static Eina_Hash   *_cache = NULL;
+static unsigned int _cache_generation = 0;
+
+// Interned namespaces, with the scan they were last seen in.
+typedef struct _Ns_Entry
+{
+   Proc_Namespaces ns;
+   unsigned int    generation;
+} Ns_Entry;
+
+static void
+_proc_cache_close(Proc_Cache *cache)
+{
+   if (cache->io_fd >= 0)
+     close(cache->io_fd);
+   if (cache->sched_fd >= 0)
+     close(cache->sched_fd);
+   if (cache->smaps_fd >= 0)
+     close(cache->smaps_fd);
+   if (cache->dir_fd >= 0)
+     close(cache->dir_fd);
+}
+
+static void
+_proc_cache_free(void *data)
+{
+   Proc_Cache *cache = data;
+
+   _proc_cache_close(cache);
+
+   free(cache);
+}
+
+static Proc_Cache *
+_proc_cache_get(pid_t pid, unsigned long long start_time, Eina_Bool create)
+{
+   Proc_Cache *cache;
+   struct rlimit rlim;
+
+   if (!_cache)
+     {
+        if (!create) return NULL;
+
+        _cache = eina_hash_int32_new(_proc_cache_free);
+
+        // One descriptor per process adds up quickly. This raises the
+        // limit of the whole program, see proc_info_flags_set().
+        if (!getrlimit(RLIMIT_NOFILE, &rlim) && rlim.rlim_cur < rlim.rlim_max)
+          {
+             rlim.rlim_cur = rlim.rlim_max;
+             setrlimit(RLIMIT_NOFILE, &rlim);
+          }
+     }
+
+   cache = eina_hash_find(_cache, &pid);
+   if (cache && cache->start_time != start_time)
+     {
+        // Same pid, different process.
+        _proc_cache_close(cache);
+        memset(cache, 0, sizeof(Proc_Cache));
+        cache->pid = pid;
+        cache->start_time = start_time;
+        cache->io_fd = cache->sched_fd = cache->smaps_fd = cache->dir_fd = -1;
+     }
+   else if (!cache)
+     {
+        if (!create) return NULL;
+
+        cache = calloc(1, sizeof(Proc_Cache));
+        if (!cache) return NULL;
+
+        cache->pid = pid;
+        cache->start_time = start_time;
+        cache->io_fd = cache->sched_fd = cache->smaps_fd = cache->dir_fd = -1;
+        eina_hash_add(_cache, &cache->pid, cache);
+     }
+
+   cache->generation = _cache_generation;
+   // Whether or not namespaces are read, those of a live process stay.
+   if (cache->ns)
+     ((Ns_Entry *) cache->ns)->generation = _cache_generation;
+
+   return cache;
+}
+
+static Eina_Bool
+_proc_cache_stale_cb(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata)
+{
+   Proc_Cache *cache = data;
+   Eina_List **stale = fdata;
+
+   if (cache->generation != _cache_generation)
+     *stale = eina_list_append(*stale, key);
+
+   return EINA_TRUE;
+}
+
+static void
+_proc_cache_sweep(void)
+{
+   Eina_List *stale = NULL;
+   const void *key;
+
+   if (!_cache) return;
+
+   eina_hash_foreach(_cache, _proc_cache_stale_cb, &stale);
+
+   EINA_LIST_FREE(stale, key)
+     eina_hash_del_by_key(_cache, key);
+}
+
+static Eina_Bool
+_proc_cache_dir_close_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED, void *data,
+                         void *fdata EINA_UNUSED)
+{
+   Proc_Cache *cache = data;
+
+   // Denied directories stay so, they aren't opened again.
+   if (cache->dir_fd >= 0)
+     {
+        close(cache->dir_fd);
+        cache->dir_fd = -1;
+     }
+
+   return EINA_TRUE;
+}
+
+// Namespaces are no longer read, only proc_info_by_pid() opens one again.
+static void
+_proc_cache_dirs_close(void)
+{
+   if (!_cache) return;
+
+   eina_hash_foreach(_cache, _proc_cache_dir_close_cb, NULL);
+}
+
+static ssize_t
+_proc_cache_read(Proc_Cache *cache, int *fd, const char *name, char *buf, size_t len)
+{
+   char path[PATH_MAX];
+   ssize_t bytes;
+   int tries = 0;
+
+   if (*fd == FD_DENIED)
+     return -1;
+
+   snprintf(path, sizeof(path), "/proc/%d/%s", cache->pid, name);
+
+   while (tries++ < 2)
+     {
+        if (*fd < 0)
+          {
+             *fd = open(path, O_RDONLY | O_CLOEXEC);
+             if (*fd < 0)
+               {
+                  // Out of descriptors the open is tried again on the
+                  // next poll, after the sweep closed those of exited
+                  // processes.
+                  if (errno == EACCES || errno == EPERM)
+                    *fd = FD_DENIED;
+                  else
+                    *fd = -1;
+                  return -1;
+               }
+          }
+
+        bytes = pread(*fd, buf, len - 1, 0);
+        if (bytes > 0)
+          {
+             buf[bytes] = '\0';
+             return bytes;
+          }
+
+        // The process went away, its pid may since have been reused.
+        close(*fd);
+        *fd = -1;
+     }
+
+   return -1;
+}
+
+static void
+_proc_io_get(Proc_Cache *cache, Proc_Stats *p)
+{
+   char buf[512];
+   unsigned long long syscr, syscw, read_bytes, write_bytes;
+
+   if (!cache) return;
+
+   if (_proc_cache_read(cache, &cache->io_fd, "io", buf, sizeof(buf)) <= 0)
+     return;
+
+   if (sscanf(buf, "rchar: %*u\nwchar: %*u\nsyscr: %llu\nsyscw: %llu\nread_bytes: %llu\nwrite_bytes: %llu",
+              &syscr, &syscw, &read_bytes, &write_bytes) != 4)
+     return;
+
+   p->io_syscr = syscr;
+   p->io_syscw = syscw;
+   p->io_read_bytes = read_bytes;
+   p->io_write_bytes = write_bytes;
+}
+
+static void
+_proc_sched_get(Proc_Cache *cache, Proc_Stats *p)
+{
+   char buf[128];
+   unsigned long long run_time, wait_time, timeslices;
+
+   if (!cache) return;
+
+   if (_proc_cache_read(cache, &cache->sched_fd, "schedstat", buf, sizeof(buf)) <= 0)
+     return;
+
+   if (sscanf(buf, "%llu %llu %llu", &run_time, &wait_time, &timeslices) != 3)
+     return;
+
+   p->sched_run_time = run_time;
+   p->sched_wait_time = wait_time;
+   p->sched_timeslices = timeslices;
+}
+
+static void
+_proc_cgroup_get(Proc_Cache *cache, Proc_Stats *p)
+{
+   char buf[4096], *line;
+   double now;
+   int fd = -1;
+
+   if (!cache) return;
+
+   now = ecore_time_get();
+
+   if (!cache->cgroup || cache->cgroup_epoch != _cgroup_epoch ||
+       (now - cache->cgroup_time) >= PROC_CGROUP_REFRESH)
+     {
+        cache->cgroup_epoch = _cgroup_epoch;
+        cache->cgroup_time = now;
+
+        if (_proc_cache_read(cache, &fd, "cgroup", buf, sizeof(buf)) > 0)
+          {
+             // The unified hierarchy is the "0::/path" line.
+             for (line = buf; line; line = strchr(line, '\n'), line = line ? line + 1 : NULL)
+               {
+                  if (!strncmp(line, "0::", 3))
+                    {
+                       line[strcspn(line, "\n")] = '\0';
+                       cache->cgroup = cgroup_path_intern(line + 3);
+                       break;
+                    }
+               }
+          }
+        if (fd >= 0)
+          close(fd);
+     }
+
+   if (cache->cgroup)
+     cgroup_path_touch(cache->cgroup);
+
+   p->cgroup = cache->cgroup;
+}
+
+static const char *_ns_names[] = { "ns/pid", "ns/mnt", "ns/net" };
+
+#define NS_COUNT (sizeof(_ns_names) / sizeof(_ns_names[0]))
+
+static Eina_Hash *_namespaces = NULL;
+
+static void
+_proc_ns_free(void *data)
+{
+   Ns_Entry *entry = data;
+
+   eina_stringshare_del(entry->ns.name);
+   free(entry);
+}
+
+static Eina_Bool
+_proc_ns_stale_cb(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata)
+{
+   Ns_Entry *entry = data;
+   Eina_List **stale = fdata;
+
+   if (entry->generation + 1 < _cache_generation)
+     *stale = eina_list_append(*stale, key);
+
+   return EINA_TRUE;
+}
+
+// Free the namespaces not seen in the last two scans, which leaves those
+// of the processes listed before this scan valid until the next.
+static void
+_proc_ns_sweep(void)
+{
+   Eina_List *stale = NULL;
+   const void *key;
+
+   if (!_namespaces) return;
+
+   eina_hash_foreach(_namespaces, _proc_ns_stale_cb, &stale);
+
+   EINA_LIST_FREE(stale, key)
+     eina_hash_del_by_key(_namespaces, key);
+}
+
+static const Proc_Namespaces *
+_proc_ns_intern(const uint64_t inodes[NS_COUNT])
+{
+   static uint64_t host[NS_COUNT];
+   static Eina_Bool host_checked = EINA_FALSE;
+   Ns_Entry *entry;
+   Proc_Namespaces *ns;
+   struct stat st;
+   const char *name;
+   unsigned int i;
+
+   if (!host_checked)
+     {
+        for (i = 0; i < NS_COUNT; i++)
+          {
+             if (!stat(eina_slstr_printf("/proc/self/%s", _ns_names[i]), &st))
+               host[i] = st.st_ino;
+          }
+        host_checked = EINA_TRUE;
+     }
+
+   if (!_namespaces)
+     _namespaces = eina_hash_string_superfast_new(_proc_ns_free);
+
+   name = eina_slstr_printf("pid:[%llu] mnt:[%llu] net:[%llu]", (unsigned long long) inodes[0],
+                            (unsigned long long) inodes[1], (unsigned long long) inodes[2]);
+
+   entry = eina_hash_find(_namespaces, name);
+   if (entry)
+     {
+        entry->generation = _cache_generation;
+        return &entry->ns;
+     }
+
+   entry = calloc(1, sizeof(Ns_Entry));
+   if (!entry) return NULL;
+
+   entry->generation = _cache_generation;
+   ns = &entry->ns;
+   ns->pid = inodes[0];
+   ns->mnt = inodes[1];
+   ns->net = inodes[2];
+   ns->name = eina_stringshare_add(name);
+   ns->host = !memcmp(inodes, host, sizeof(host));
+
+   eina_hash_add(_namespaces, ns->name, entry);
+
+   return ns;
+}
+
+static void
+_proc_ns_get(Proc_Cache *cache, Proc_Stats *p)
+{
+   char path[PATH_MAX];
+   struct stat st;
+   uint64_t inodes[NS_COUNT];
+   unsigned int i;
+
+   if (!cache || cache->dir_fd == FD_DENIED) return;
+
+   // The directory stays bound to this process even if its pid is reused.
+   if (cache->dir_fd < 0)
+     {
+        snprintf(path, sizeof(path), "/proc/%d", cache->pid);
+        cache->dir_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (cache->dir_fd < 0) return;
+     }
+
+   // The links resolve to the namespaces, their inode numbers identify them.
+   for (i = 0; i < NS_COUNT; i++)
+     {
+        if (fstatat(cache->dir_fd, _ns_names[i], &st, 0) < 0)
+          {
+             if (errno == EACCES || errno == EPERM)
+               {
+                  close(cache->dir_fd);
+                  cache->dir_fd = FD_DENIED;
+               }
+             return;
+          }
+        inodes[i] = st.st_ino;
+     }
+
+   // Namespaces can change with setns() or unshare(), but rarely do.
+   if (!cache->ns || cache->ns->pid != inodes[0] || cache->ns->mnt != inodes[1] ||
+       cache->ns->net != inodes[2])
+     cache->ns = _proc_ns_intern(inodes);
+
+   p->ns = cache->ns;
+}
+
+// "NSpid:\t1234\t12", the last is the pid in the innermost namespace.
+static pid_t
+_proc_ns_pid_parse(const char *line)
+{
+   const char *p = strrchr(line, '\t');
+
+   if (!p) p = strchr(line, ':');
+
+   return atoi(p + 1);
+}
+
+static const struct
+{
+   const char *key;
+   size_t      len;
+   size_t      offset;
+} _smaps_keys[] = {
+   { "Pss:", 4, offsetof(Proc_Cache, mem_pss) },
+   { "Private_Clean:", 14, offsetof(Proc_Cache, mem_uss) },
+   { "Private_Dirty:", 14, offsetof(Proc_Cache, mem_uss) },
+   { "AnonHugePages:", 14, offsetof(Proc_Cache, mem_anon_huge) },
+   { "Swap:", 5, offsetof(Proc_Cache, mem_swap) },
+};
+
+static void
+_proc_smaps_get(Proc_Cache *cache)
+{
+   char buf[4096], *line, *next;
+   size_t i, count = sizeof(_smaps_keys) / sizeof(_smaps_keys[0]);
+
+   cache->mem_pss = cache->mem_uss = cache->mem_swap = cache->mem_anon_huge = 0;
+   cache->smaps_valid = EINA_FALSE;
+
+   if (_proc_cache_read(cache, &cache->smaps_fd, "smaps_rollup", buf, sizeof(buf)) <= 0)
+     return;
+
+   // The first line is the [rollup] mapping header.
+   for (line = strchr(buf, '\n'); line; line = next)
+     {
+        line++;
+        next = strchr(line, '\n');
+
+        for (i = 0; i < count; i++)
+          {
+             if (!strncmp(line, _smaps_keys[i].key, _smaps_keys[i].len))
+               {
+                  int64_t *value = (int64_t *) ((char *) cache + _smaps_keys[i].offset);
+                  *value += strtoll(line + _smaps_keys[i].len, NULL, 10) * 1024;
+                  cache->smaps_valid = EINA_TRUE;
+                  break;
+               }
+          }
+     }
+}
+
+Eina_Bool
+proc_info_memory_get(Proc_Stats *proc, Eina_Bool refresh)
+{
+   Proc_Cache *cache;
+   Eina_Bool updated = EINA_FALSE;
+   double now;
+
+   proc->mem_detail = EINA_FALSE;
+
+   cache = _proc_cache_get(proc->pid, proc->start_time, refresh);
+   if (!cache) return EINA_FALSE;
+
+   if (refresh && cache->smaps_fd != FD_DENIED)
+     {
+        now = ecore_time_get();
+        if (!cache->smaps_time || (now - cache->smaps_time) >= PROC_MEMORY_REFRESH)
+          {
+             _proc_smaps_get(cache);
+             cache->smaps_time = now;
+             updated = EINA_TRUE;
+          }
+     }
+
+   if (cache->smaps_valid)
+     {
+        proc->mem_pss = cache->mem_pss;
+        proc->mem_uss = cache->mem_uss;
+        proc->mem_swap = cache->mem_swap;
+        proc->mem_anon_huge = cache->mem_anon_huge;
+        proc->mem_detail = EINA_TRUE;
+     }
+
+   return updated;
+}
+
+static long
+_clk_tck_get(void)
+{
+   static long clk_tck = 0;
+
+   if (!clk_tck)
+     {
+        clk_tck = sysconf(_SC_CLK_TCK);
+        if (clk_tck <= 0)
+          clk_tck = 100;
+     }
+
+   return clk_tck;
+}
+
 static unsigned long
 _parse_line(const char *line)
 {
@@ -142,10 +717,16 @@ _process_list_linux_get(void)
    Eina_List *files, *list = NULL;
    FILE *f;
    char path[PATH_MAX], line[4096], program_name[1024], state;
-   int pid, res, utime, stime, cutime, cstime, uid, psr, pri, nice, numthreads;
+   int pid, ppid, res, utime, stime, cutime, cstime, uid, psr, pri, nice, numthreads;
    unsigned int mem_size, mem_rss;
+   unsigned long long start_time, minflt, majflt;
+   pid_t ns_pid;
+   Proc_Cache *cache;
 
    int pagesize = getpagesize();
+   long clk_tck = _clk_tck_get();
+
+   _cache_generation++;
 
    files = ecore_file_ls("/proc");
    EINA_LIST_FREE(files, name)
@@ -168,9 +749,9 @@ _process_list_linux_get(void)
              strncpy(program_name, start, end - start);
              program_name[end - start] = '\0';
 
-             res = sscanf(end + 2, "%c %d %d %d %d %d %u %u %u %u %u %d %d %d %d %d %d %u %u %d %u %u %u %u %u %u %u %u %d %d %d %d %u %d %d %d %d %d %d %d %d %d",
-                          &state, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &utime, &stime, &cutime, &cstime,
-                          &pri, &nice, &numthreads, &dummy, &dummy, &mem_size, &mem_rss, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy,
+             res = sscanf(end + 2, "%c %d %d %d %d %d %u %llu %u %llu %u %d %d %d %d %d %d %u %u %llu %u %u %u %u %u %u %u %u %d %d %d %d %u %d %d %d %d %d %d %d %d %d",
+                          &state, &ppid, &dummy, &dummy, &dummy, &dummy, &dummy, &minflt, &dummy, &majflt, &dummy, &utime, &stime, &cutime, &cstime,
+                          &pri, &nice, &numthreads, &dummy, &start_time, &mem_size, &mem_rss, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy,
                           &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &psr, &dummy, &dummy, &dummy, &dummy, &dummy);
           }
 
@@ -183,11 +764,19 @@ _process_list_linux_get(void)
         f = fopen(path, "r");
         if (!f) continue;
 
+        ns_pid = 0;
         while ((fgets(line, sizeof(line), f)) != NULL)
           {
              if (!strncmp(line, "Uid:", 4))
                {
                   uid = _parse_line(line);
+                  // NSpid comes a few lines later.
+                  if (!(_flags & PROC_INFO_FLAG_NS))
+                    break;
+               }
+             else if (!strncmp(line, "NSpid:", 6))
+               {
+                  ns_pid = _proc_ns_pid_parse(line);
                   break;
                }
           }
@@ -197,16 +786,34 @@ _process_list_linux_get(void)
         Proc_Stats *p = calloc(1, sizeof(Proc_Stats));
 
         p->pid = pid;
+        p->ppid = ppid;
         p->uid = uid;
         p->cpu_id = psr;
         snprintf(p->command, sizeof(p->command), "%s", program_name);
         p->state = _process_state_name(state);
-        p->cpu_time = utime + stime;
+        p->cpu_time = ((int64_t) utime + stime) * 1000000 / clk_tck;
         p->mem_size = mem_size;
         p->mem_rss = mem_rss * pagesize;
         p->nice = nice;
         p->priority = pri;
         p->numthreads = numthreads;
+        p->minflt = minflt;
+        p->majflt = majflt;
+        p->ns_pid = ns_pid;
+
+        p->start_time = start_time;
+
+        // Keep existing cache entries alive, only create them when needed.
+        cache = _proc_cache_get(pid, start_time, _flags & (PROC_INFO_FLAG_IO | PROC_INFO_FLAG_SCHED |
+                                                           PROC_INFO_FLAG_CGROUP | PROC_INFO_FLAG_NS));
+        if (_flags & PROC_INFO_FLAG_IO)
+          _proc_io_get(cache, p);
+        if (_flags & PROC_INFO_FLAG_SCHED)
+          _proc_sched_get(cache, p);
+        if (_flags & PROC_INFO_FLAG_CGROUP)
+          _proc_cgroup_get(cache, p);
+        if (_flags & PROC_INFO_FLAG_NS)
+          _proc_ns_get(cache, p);
 
         list = eina_list_append(list, p);
      }
@@ -214,6 +821,9 @@ _process_list_linux_get(void)
    if (files)
      eina_list_free(files);
 
+   _proc_cache_sweep();
+   _proc_ns_sweep();
+
    return list;
 }
 
@@ -224,8 +834,11 @@ proc_info_by_pid(int pid)
    char path[PATH_MAX];
    char line[4096];
    char state, program_name[1024];
-   int res, dummy, utime, stime, cutime, cstime, uid, psr;
+   int res, dummy, ppid, utime, stime, cutime, cstime, uid, psr;
    unsigned int mem_size, mem_rss, pri, nice, numthreads;
+   unsigned long long start_time, minflt, majflt;
+   pid_t ns_pid = 0;
+   Proc_Cache *cache;
 
    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
    if (!ecore_file_exists(path))
@@ -241,9 +854,9 @@ proc_info_by_pid(int pid)
         strncpy(program_name, start, end - start);
         program_name[end - start] = '\0';
 
-        res = sscanf(end + 2, "%c %d %d %d %d %d %u %u %u %u %u %d %d %d %d %d %d %u %u %d %u %u %u %u %u %u %u %u %d %d %d %d %u %d %d %d %d %d %d %d %d %d",
-                     &state, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &utime, &stime, &cutime, &cstime,
-                     &pri, &nice, &numthreads, &dummy, &dummy, &mem_size, &mem_rss, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy,
+        res = sscanf(end + 2, "%c %d %d %d %d %d %u %llu %u %llu %u %d %d %d %d %d %d %u %u %llu %u %u %u %u %u %u %u %u %d %d %d %d %u %d %d %d %d %d %d %d %d %d",
+                     &state, &ppid, &dummy, &dummy, &dummy, &dummy, &dummy, &minflt, &dummy, &majflt, &dummy, &utime, &stime, &cutime, &cstime,
+                     &pri, &nice, &numthreads, &dummy, &start_time, &mem_size, &mem_rss, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy,
                      &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &psr, &dummy, &dummy, &dummy, &dummy, &dummy);
      }
    fclose(f);
@@ -258,8 +871,10 @@ proc_info_by_pid(int pid)
    while ((fgets(line, sizeof(line), f)) != NULL)
      {
         if (!strncmp(line, "Uid:", 4))
+          uid = _parse_line(line);
+        else if (!strncmp(line, "NSpid:", 6))
           {
-             uid = _parse_line(line);
+             ns_pid = _proc_ns_pid_parse(line);
              break;
           }
      }
@@ -267,20 +882,583 @@ proc_info_by_pid(int pid)
 
    Proc_Stats *p = calloc(1, sizeof(Proc_Stats));
    p->pid = pid;
+   p->ppid = ppid;
    p->uid = uid;
    p->cpu_id = psr;
    snprintf(p->command, sizeof(p->command), "%s", program_name);
    p->state = _process_state_name(state);
-   p->cpu_time = utime + stime;
+   p->cpu_time = ((int64_t) utime + stime) * 1000000 / _clk_tck_get();
    p->mem_size = mem_size;
    p->mem_rss = mem_rss * getpagesize();
    p->priority = pri;
    p->nice = nice;
    p->numthreads = numthreads;
+   p->minflt = minflt;
+   p->majflt = majflt;
+   p->ns_pid = ns_pid;
+
+   p->start_time = start_time;
+
+   cache = _proc_cache_get(pid, start_time, EINA_TRUE);
+   _proc_io_get(cache, p);
+   _proc_sched_get(cache, p);
+   _proc_cgroup_get(cache, p);
+   _proc_ns_get(cache, p);
+
+   p->timestamp = _proc_timestamp();
 
    return p;
 }
 
+typedef struct _Proc_Thread_Cache
+{
+   pid_t              tid;
+   unsigned long long start_time;
+   unsigned int       generation;
+   int                stat_fd;
+   int                status_fd;
+   int64_t            cpu_time;
+   double             timestamp;
+} Proc_Thread_Cache;
+
+static Eina_Hash   *_threads = NULL;
+static unsigned int _threads_generation = 0;
+static DIR         *_task_dir = NULL;
+static pid_t        _task_pid = -1;
+
+static void
+_thread_cache_free(void *data)
+{
+   Proc_Thread_Cache *cache = data;
+
+   if (cache->stat_fd >= 0)
+     close(cache->stat_fd);
+   if (cache->status_fd >= 0)
+     close(cache->status_fd);
+
+   free(cache);
+}
+
+static ssize_t
+_thread_read(pid_t tid, int *fd, const char *name, char *buf, size_t len)
+{
+   ssize_t bytes;
+   int tries = 0;
+
+   while (tries++ < 2)
+     {
+        if (*fd < 0)
+          {
+             *fd = openat(dirfd(_task_dir), eina_slstr_printf("%d/%s", tid, name), O_RDONLY | O_CLOEXEC);
+             if (*fd < 0) return -1;
+          }
+
+        bytes = pread(*fd, buf, len - 1, 0);
+        if (bytes > 0)
+          {
+             buf[bytes] = '\0';
+             return bytes;
+          }
+
+        // The thread exited, its id may since have been reused.
+        close(*fd);
+        *fd = -1;
+     }
+
+   return -1;
+}
+
+// Field n of proc(5) stat, where fields[0] is field 3, the state.
+#define STAT_FIELD(n) ((n) - 3)
+
+// Split a stat line in place. The name may hold spaces and parentheses,
+// so it ends at the last ')'.
+static int
+_stat_split(char *buf, char *name, size_t size, char **fields, int max)
+{
+   char *start, *end, *p;
+   int n = 0;
+
+   start = strchr(buf, '(');
+   end = strrchr(buf, ')');
+   if (!start || !end || end < start || end[1] != ' ')
+     return 0;
+
+   *end = '\0';
+   eina_strlcpy(name, start + 1, size);
+
+   for (p = end + 2; p && *p && n < max; n++)
+     {
+        fields[n] = p;
+        p = strchr(p, ' ');
+        if (p) *p++ = '\0';
+     }
+
+   return n;
+}
+
+static uint64_t
+_status_value(const char *buf, const char *key)
+{
+   const char *p = strstr(buf, key);
+
+   if (!p) return 0;
+
+   return strtoull(p + strlen(key), NULL, 10);
+}
+
+static Eina_Bool
+_thread_stale_cb(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata)
+{
+   Proc_Thread_Cache *cache = data;
+   Eina_List **stale = fdata;
+
+   if (cache->generation != _threads_generation)
+     *stale = eina_list_append(*stale, key);
+
+   return EINA_TRUE;
+}
+
+Eina_List *
+proc_info_threads_get(pid_t pid)
+{
+   struct dirent *dh;
+   Eina_List *stale = NULL, *list = NULL;
+   Proc_Thread_Cache *cache;
+   Proc_Thread *t;
+   const void *key;
+   char buf[8192], path[PATH_MAX], *fields[STAT_FIELD(39) + 1];
+   unsigned long long start_time;
+   int64_t cpu_time;
+   double now;
+   pid_t tid;
+
+   if (pid != _task_pid)
+     {
+        proc_info_threads_clear();
+
+        snprintf(path, sizeof(path), "/proc/%d/task", pid);
+        _task_dir = opendir(path);
+        if (!_task_dir) return NULL;
+
+        _task_pid = pid;
+        _threads = eina_hash_int32_new(_thread_cache_free);
+     }
+
+   if (!_task_dir) return NULL;
+
+   _threads_generation++;
+   now = _proc_timestamp();
+
+   rewinddir(_task_dir);
+   while ((dh = readdir(_task_dir)))
+     {
+        tid = atoi(dh->d_name);
+        if (!tid) continue;
+
+        cache = eina_hash_find(_threads, &tid);
+        if (!cache)
+          {
+             cache = calloc(1, sizeof(Proc_Thread_Cache));
+             if (!cache) continue;
+
+             cache->tid = tid;
+             cache->stat_fd = cache->status_fd = -1;
+             eina_hash_add(_threads, &cache->tid, cache);
+          }
+
+        if (_thread_read(tid, &cache->stat_fd, "stat", buf, sizeof(buf)) <= 0)
+          continue;
+
+        t = calloc(1, sizeof(Proc_Thread));
+        if (!t) continue;
+
+        if (_stat_split(buf, t->name, sizeof(t->name), fields, STAT_FIELD(39) + 1) != STAT_FIELD(39) + 1)
+          {
+             free(t);
+             continue;
+          }
+
+        t->tid = tid;
+        t->state = _process_state_name(fields[STAT_FIELD(3)][0]);
+        t->cpu_id = atoi(fields[STAT_FIELD(39)]);
+
+        cpu_time = (int64_t) (strtoull(fields[STAT_FIELD(14)], NULL, 10) +
+                              strtoull(fields[STAT_FIELD(15)], NULL, 10)) * 1000000 / _clk_tck_get();
+        start_time = strtoull(fields[STAT_FIELD(22)], NULL, 10);
+
+        if (cache->timestamp && cache->start_time == start_time && now > cache->timestamp &&
+            cpu_time >= cache->cpu_time)
+          t->cpu_usage = (cpu_time - cache->cpu_time) / 10000.0 / (now - cache->timestamp);
+
+        cache->start_time = start_time;
+        cache->cpu_time = cpu_time;
+        cache->timestamp = now;
+        cache->generation = _threads_generation;
+
+        if (_thread_read(tid, &cache->status_fd, "status", buf, sizeof(buf)) > 0)
+          {
+             t->ctxt_voluntary = _status_value(buf, "\nvoluntary_ctxt_switches:");
+             t->ctxt_involuntary = _status_value(buf, "\nnonvoluntary_ctxt_switches:");
+          }
+
+        list = eina_list_append(list, t);
+     }
+
+   // Threads come and go, drop those that have exited.
+   eina_hash_foreach(_threads, _thread_stale_cb, &stale);
+
+   EINA_LIST_FREE(stale, key)
+     eina_hash_del_by_key(_threads, key);
+
+   return list;
+}
+
+void
+proc_info_threads_clear(void)
+{
+   if (_threads)
+     eina_hash_free(_threads);
+   _threads = NULL;
+
+   if (_task_dir)
+     closedir(_task_dir);
+   _task_dir = NULL;
+   _task_pid = -1;
+}
+
+int
+proc_info_numa_get(pid_t pid, uint64_t *node_bytes, int max)
+{
+   FILE *f;
+   char path[64], line[4096], *tok, *save;
+   uint64_t pages[PROC_NUMA_NODES_MAX];
+   unsigned long count, page_size;
+   int i, node, nodes = 0;
+
+   if (max > PROC_NUMA_NODES_MAX)
+     max = PROC_NUMA_NODES_MAX;
+
+   for (i = 0; i < max; i++)
+     node_bytes[i] = 0;
+
+   snprintf(path, sizeof(path), "/proc/%d/numa_maps", pid);
+   f = fopen(path, "r");
+   if (!f) return 0;
+
+   // "7f1c2a000000 default file=/usr/lib/libc.so.6 mapped=12 N0=8 N1=4 kernelpagesize_kB=4"
+   while (fgets(line, sizeof(line), f))
+     {
+        memset(pages, 0, sizeof(pages));
+        page_size = 4;
+
+        for (tok = strtok_r(line, " \n", &save); tok; tok = strtok_r(NULL, " \n", &save))
+          {
+             if (sscanf(tok, "N%d=%lu", &node, &count) == 2)
+               {
+                  if (node >= 0 && node < max)
+                    {
+                       pages[node] += count;
+                       if (node >= nodes) nodes = node + 1;
+                    }
+               }
+             else if (!strncmp(tok, "kernelpagesize_kB=", 18))
+               page_size = strtoul(tok + 18, NULL, 10);
+          }
+
+        for (i = 0; i < nodes; i++)
+          node_bytes[i] += pages[i] * page_size * 1024;
+     }
+
+   fclose(f);
+
+   return nodes;
+}
+
+// Socket inode to a description of the connection, and the buffer the
+// /proc/<pid>/net tables are read through. Both kept between calls.
+static Eina_Hash *_sockets = NULL;
+static char      *_net_buf = NULL;
+
+#define NET_BUF_SIZE 65536
+
+typedef void (*Net_Line_Cb)(char *line, const char *proto);
+
+static const char *_tcp_states[] = {
+   "", "ESTABLISHED", "SYN_SENT", "SYN_RECV", "FIN_WAIT1", "FIN_WAIT2", "TIME_WAIT",
+   "CLOSE", "CLOSE_WAIT", "LAST_ACK", "LISTEN", "CLOSING",
+};
+
+// Read a table a buffer at a time, passing each line but the header.
+static void
+_net_table_parse(pid_t pid, const char *table, Net_Line_Cb cb)
+{
+   char path[64], *line, *end;
+   ssize_t bytes;
+   size_t used = 0;
+   Eina_Bool header = EINA_TRUE;
+   int fd;
+
+   if (!_net_buf)
+     {
+        _net_buf = malloc(NET_BUF_SIZE);
+        if (!_net_buf) return;
+     }
+
+   snprintf(path, sizeof(path), "/proc/%d/net/%s", pid, table);
+   fd = open(path, O_RDONLY | O_CLOEXEC);
+   if (fd < 0) return;
+
+   while ((bytes = read(fd, _net_buf + used, NET_BUF_SIZE - used - 1)) > 0)
+     {
+        used += bytes;
+        _net_buf[used] = '\0';
+
+        for (line = _net_buf; (end = strchr(line, '\n')); line = end + 1)
+          {
+             *end = '\0';
+             if (!header)
+               cb(line, table);
+             header = EINA_FALSE;
+          }
+
+        // Keep the partial line for the next read, lines are short.
+        used -= line - _net_buf;
+        if (used == NET_BUF_SIZE - 1)
+          used = 0;
+        memmove(_net_buf, line, used);
+     }
+
+   close(fd);
+}
+
+static void
+_net_socket_add(unsigned long inode, const char *desc)
+{
+   uint64_t key = inode;
+
+   if (!inode || eina_hash_find(_sockets, &key))
+     return;
+
+   eina_hash_add(_sockets, &key, strdup(desc));
+}
+
+// Addresses are words of the kernel's byte order printed as hex.
+static void
+_net_addr_format(const char *hex, Eina_Bool v6, unsigned int port, char *buf, size_t size)
+{
+   char addr[INET6_ADDRSTRLEN], word[9];
+   struct in6_addr a6;
+   struct in_addr a4;
+   uint32_t w;
+
+   if (!v6)
+     {
+        a4.s_addr = strtoul(hex, NULL, 16);
+        inet_ntop(AF_INET, &a4, addr, sizeof(addr));
+        snprintf(buf, size, "%s:%u", addr, port);
+        return;
+     }
+
+   for (int i = 0; i < 4; i++)
+     {
+        memcpy(word, hex + i * 8, 8);
+        word[8] = '\0';
+        w = strtoul(word, NULL, 16);
+        memcpy(&a6.s6_addr[i * 4], &w, 4);
+     }
+   inet_ntop(AF_INET6, &a6, addr, sizeof(addr));
+   snprintf(buf, size, "[%s]:%u", addr, port);
+}
+
+// "0: 0100007F:0277 00000000:0000 0A 00000000:00000000 00:00000000 00000000 0 0 12345 ..."
+static void
+_net_inet_line(char *line, const char *proto)
+{
+   char local[33], remote[33], from[64], to[64], desc[192];
+   const char *state = "";
+   unsigned int lport, rport, st;
+   unsigned long inode;
+   Eina_Bool v6 = proto[3] == '6';
+
+   if (sscanf(line, " %*d: %32[0-9A-Fa-f]:%x %32[0-9A-Fa-f]:%x %x %*s %*s %*s %*u %*u %lu",
+              local, &lport, remote, &rport, &st, &inode) != 6)
+     return;
+
+   if (strlen(local) != (v6 ? 32 : 8) || strlen(remote) != strlen(local))
+     return;
+
+   if (!strncmp(proto, "tcp", 3) && st < sizeof(_tcp_states) / sizeof(_tcp_states[0]))
+     state = _tcp_states[st];
+
+   _net_addr_format(local, v6, lport, from, sizeof(from));
+   if (rport)
+     _net_addr_format(remote, v6, rport, to, sizeof(to));
+
+   snprintf(desc, sizeof(desc), "%s %s%s%s%s%s", proto, from, rport ? " -> " : "", rport ? to : "",
+            state[0] ? " " : "", state);
+   _net_socket_add(inode, desc);
+}
+
+// "0000000000000000: 00000002 00000000 00010000 0001 01 12345 /run/foo.sock"
+static void
+_net_unix_line(char *line, const char *proto EINA_UNUSED)
+{
+   char desc[PATH_MAX];
+   const char *type;
+   unsigned int t, st;
+   unsigned long inode;
+   int n = 0;
+
+   if (sscanf(line, "%*s %*s %*s %*s %x %x %lu%n", &t, &st, &inode, &n) != 3)
+     return;
+
+   switch (t)
+     {
+      case 1: type = "stream"; break;
+      case 2: type = "dgram"; break;
+      case 5: type = "seqpacket"; break;
+      default: type = "?"; break;
+     }
+
+   while (line[n] == ' ')
+     n++;
+
+   snprintf(desc, sizeof(desc), "unix %s%s%s", type, line[n] ? " " : "", line + n);
+   _net_socket_add(inode, desc);
+}
+
+static void
+_net_sockets_index(pid_t pid)
+{
+   if (!_sockets)
+     _sockets = eina_hash_int64_new(free);
+   else
+     eina_hash_free_buckets(_sockets);
+
+   // The tables of the process' network namespace, not ours.
+   _net_table_parse(pid, "tcp", _net_inet_line);
+   _net_table_parse(pid, "tcp6", _net_inet_line);
+   _net_table_parse(pid, "udp", _net_inet_line);
+   _net_table_parse(pid, "udp6", _net_inet_line);
+   _net_table_parse(pid, "unix", _net_unix_line);
+}
+
+static int64_t
+_proc_fd_limit(pid_t pid)
+{
+   FILE *f;
+   char path[64], line[256], soft[32];
+   int64_t limit = -1;
+
+   snprintf(path, sizeof(path), "/proc/%d/limits", pid);
+   f = fopen(path, "r");
+   if (!f) return -1;
+
+   // "Max open files            1024                 524288               files"
+   while (fgets(line, sizeof(line), f))
+     {
+        if (sscanf(line, "Max open files %31s", soft) == 1)
+          {
+             if (isdigit(soft[0]))
+               limit = strtoll(soft, NULL, 10);
+             break;
+          }
+     }
+
+   fclose(f);
+
+   return limit;
+}
+
+static int
+_proc_fd_cmp(const void *a, const void *b)
+{
+   const Proc_Fd *one = a, *two = b;
+
+   return one->fd - two->fd;
+}
+
+Eina_List *
+proc_info_fds_get(pid_t pid, int64_t *limit)
+{
+   DIR *dir;
+   struct dirent *dh;
+   Eina_List *list = NULL, *l;
+   Proc_Fd *f;
+   const char *desc;
+   char path[64], target[PATH_MAX];
+   Eina_Bool sockets = EINA_FALSE;
+   unsigned long inode;
+   uint64_t key;
+   ssize_t len;
+   char *end;
+   long fd;
+
+   *limit = _proc_fd_limit(pid);
+
+   snprintf(path, sizeof(path), "/proc/%d/fd", pid);
+   dir = opendir(path);
+   if (!dir) return NULL;
+
+   while ((dh = readdir(dir)))
+     {
+        fd = strtol(dh->d_name, &end, 10);
+        if (dh->d_name[0] == '.' || *end) continue;
+
+        len = readlinkat(dirfd(dir), dh->d_name, target, sizeof(target) - 1);
+        if (len < 0) continue;
+        target[len] = '\0';
+
+        f = malloc(sizeof(Proc_Fd) + len + 1);
+        if (!f) break;
+        f->fd = fd;
+        memcpy(f->target, target, len + 1);
+        list = eina_list_append(list, f);
+
+        if (!strncmp(target, "socket:[", 8))
+          sockets = EINA_TRUE;
+     }
+
+   closedir(dir);
+
+   list = eina_list_sort(list, eina_list_count(list), _proc_fd_cmp);
+
+   if (!sockets)
+     return list;
+
+   // Once for all of the process' sockets.
+   _net_sockets_index(pid);
+
+   EINA_LIST_FOREACH(list, l, f)
+     {
+        if (sscanf(f->target, "socket:[%lu]", &inode) != 1)
+          continue;
+
+        key = inode;
+        desc = eina_hash_find(_sockets, &key);
+        if (!desc) continue;
+
+        f = realloc(f, sizeof(Proc_Fd) + strlen(desc) + 1);
+        if (!f) continue;
+        strcpy(f->target, desc);
+        eina_list_data_set(l, f);
+     }
+
+   return list;
+}
+
+void
+proc_info_fds_clear(void)
+{
+   if (_sockets)
+     eina_hash_free(_sockets);
+   _sockets = NULL;
+
+   free(_net_buf);
+   _net_buf = NULL;
+}
+
 #endif
 
 #if defined(__OpenBSD__)
@@ -302,13 +1480,17 @@ proc_info_by_pid(int pid)
    if (count == 0) return NULL;
    pagesize = getpagesize();
 
-   Proc_Stats *p = malloc(sizeof(Proc_Stats));
+   Proc_Stats *p = calloc(1, sizeof(Proc_Stats));
    p->pid = kp->p_pid;
+   p->ppid = kp->p_ppid;
+   p->start_time = kp->p_ustart_sec;
+   p->minflt = kp->p_uru_minflt;
+   p->majflt = kp->p_uru_majflt;
    p->uid = kp->p_uid;
    p->cpu_id = kp->p_cpuid;
    snprintf(p->command, sizeof(p->command), "%s", kp->p_comm);
    p->state = _process_state_name(kp->p_stat);
-   p->cpu_time = kp->p_uticks + kp->p_sticks + kp->p_iticks;
+   p->cpu_time = ((int64_t) kp->p_uutime_sec + kp->p_ustime_sec) * 1000000 + kp->p_uutime_usec + kp->p_ustime_usec;
    p->mem_size = (kp->p_vm_tsize * pagesize) + (kp->p_vm_dsize * pagesize) + (kp->p_vm_ssize * pagesize);
    p->mem_rss = kp->p_vm_rssize * pagesize;
    p->priority = kp->p_priority - PZERO;
@@ -325,6 +1507,8 @@ proc_info_by_pid(int pid)
 
    kvm_close(kern);
 
+   p->timestamp = _proc_timestamp();
+
    return p;
 }
 
@@ -348,13 +1532,17 @@ _process_list_openbsd_get(void)
 
    for (int i = 0; i < pid_count; i++)
      {
-        p = malloc(sizeof(Proc_Stats));
+        p = calloc(1, sizeof(Proc_Stats));
         p->pid = kp[i].p_pid;
+        p->ppid = kp[i].p_ppid;
+        p->start_time = kp[i].p_ustart_sec;
+        p->minflt = kp[i].p_uru_minflt;
+        p->majflt = kp[i].p_uru_majflt;
         p->uid = kp[i].p_uid;
         p->cpu_id = kp[i].p_cpuid;
         snprintf(p->command, sizeof(p->command), "%s", kp[i].p_comm);
         p->state = _process_state_name(kp[i].p_stat);
-        p->cpu_time = kp[i].p_uticks + kp[i].p_sticks + kp[i].p_iticks;
+        p->cpu_time = ((int64_t) kp[i].p_uutime_sec + kp[i].p_ustime_sec) * 1000000 + kp[i].p_uutime_usec + kp[i].p_ustime_usec;
         p->mem_size = (kp[i].p_vm_tsize * pagesize) + (kp[i].p_vm_dsize * pagesize) + (kp[i].p_vm_ssize * pagesize);
         p->mem_rss = kp[i].p_vm_rssize * pagesize;
         p->priority = kp[i].p_priority - PZERO;
@@ -395,11 +1583,15 @@ _process_list_macos_get(void)
 
         Proc_Stats *p = calloc(1, sizeof(Proc_Stats));
         p->pid = i;
+        p->ppid = taskinfo.pbsd.pbi_ppid;
+        p->start_time = taskinfo.pbsd.pbi_start_tvsec;
+        p->minflt = taskinfo.ptinfo.pti_faults;
+        p->majflt = taskinfo.ptinfo.pti_pageins;
         p->uid = taskinfo.pbsd.pbi_uid;
         p->cpu_id = -1;
         snprintf(p->command, sizeof(p->command), "%s", taskinfo.pbsd.pbi_comm);
         p->cpu_time = taskinfo.ptinfo.pti_total_user + taskinfo.ptinfo.pti_total_system;
-        p->cpu_time /= 10000000;
+        p->cpu_time /= 1000;
         p->state = _process_state_name(taskinfo.pbsd.pbi_status);
         p->mem_size = taskinfo.ptinfo.pti_virtual_size;
         p->mem_rss = taskinfo.ptinfo.pti_resident_size;
@@ -431,11 +1623,15 @@ proc_info_by_pid(int pid)
 
    Proc_Stats *p = calloc(1, sizeof(Proc_Stats));
    p->pid = pid;
+   p->ppid = taskinfo.pbsd.pbi_ppid;
+   p->start_time = taskinfo.pbsd.pbi_start_tvsec;
+   p->minflt = taskinfo.ptinfo.pti_faults;
+   p->majflt = taskinfo.ptinfo.pti_pageins;
    p->uid = taskinfo.pbsd.pbi_uid;
    p->cpu_id = workqueue.pwq_nthreads;
    snprintf(p->command, sizeof(p->command), "%s", taskinfo.pbsd.pbi_comm);
    p->cpu_time = taskinfo.ptinfo.pti_total_user + taskinfo.ptinfo.pti_total_system;
-   p->cpu_time /= 10000000;
+   p->cpu_time /= 1000;
    p->state = _process_state_name(taskinfo.pbsd.pbi_status);
    p->mem_size = taskinfo.ptinfo.pti_virtual_size;
    p->mem_rss = taskinfo.ptinfo.pti_resident_size;
@@ -443,6 +1639,8 @@ proc_info_by_pid(int pid)
    p->nice = taskinfo.pbsd.pbi_nice;
    p->numthreads = taskinfo.ptinfo.pti_threadnum;
 
+   p->timestamp = _proc_timestamp();
+
    return p;
 }
 
@@ -480,6 +1678,10 @@ _process_list_freebsd_get(void)
         Proc_Stats *p = calloc(1, sizeof(Proc_Stats));
 
         p->pid = kp.ki_pid;
+        p->ppid = kp.ki_ppid;
+        p->start_time = kp.ki_start.tv_sec;
+        p->minflt = kp.ki_rusage.ru_minflt;
+        p->majflt = kp.ki_rusage.ru_majflt;
         p->uid = kp.ki_uid;
         snprintf(p->command, sizeof(p->command), "%s", kp.ki_comm);
         p->cpu_id = kp.ki_oncpu;
@@ -489,7 +1691,6 @@ _process_list_freebsd_get(void)
         usage = &kp.ki_rusage;
 
         p->cpu_time = (usage->ru_utime.tv_sec * 1000000) + usage->ru_utime.tv_usec + (usage->ru_stime.tv_sec * 1000000) + usage->ru_stime.tv_usec;
-        p->cpu_time /= 10000;
         p->state = _process_state_name(kp.ki_stat);
         p->mem_size = kp.ki_size;
         p->mem_rss = kp.ki_rssize * pagesize;
@@ -524,6 +1725,10 @@ proc_info_by_pid(int pid)
 
    Proc_Stats *p = calloc(1, sizeof(Proc_Stats));
    p->pid = kp.ki_pid;
+   p->ppid = kp.ki_ppid;
+   p->start_time = kp.ki_start.tv_sec;
+   p->minflt = kp.ki_rusage.ru_minflt;
+   p->majflt = kp.ki_rusage.ru_majflt;
    p->uid = kp.ki_uid;
    snprintf(p->command, sizeof(p->command), "%s", kp.ki_comm);
    p->cpu_id = kp.ki_oncpu;
@@ -533,7 +1738,6 @@ proc_info_by_pid(int pid)
    usage = &kp.ki_rusage;
 
    p->cpu_time = (usage->ru_utime.tv_sec * 1000000) + usage->ru_utime.tv_usec + (usage->ru_stime.tv_sec * 1000000) + usage->ru_stime.tv_usec;
-   p->cpu_time /= 10000;
    p->state = _process_state_name(kp.ki_stat);
    p->mem_size = kp.ki_size;
    p->mem_rss = kp.ki_rssize * pagesize;
@@ -541,15 +1745,61 @@ proc_info_by_pid(int pid)
    p->priority = kp.ki_pri.pri_level - PZERO;
    p->numthreads = kp.ki_numthreads;
 
+   p->timestamp = _proc_timestamp();
+
    return p;
 }
 
 #endif
 
+#if !defined(__linux__)
+
+Eina_Bool
+proc_info_memory_get(Proc_Stats *proc, Eina_Bool refresh EINA_UNUSED)
+{
+   proc->mem_detail = EINA_FALSE;
+
+   return EINA_FALSE;
+}
+
+Eina_List *
+proc_info_threads_get(pid_t pid EINA_UNUSED)
+{
+   return NULL;
+}
+
+void
+proc_info_threads_clear(void)
+{
+}
+
+int
+proc_info_numa_get(pid_t pid EINA_UNUSED, uint64_t *node_bytes EINA_UNUSED, int max EINA_UNUSED)
+{
+   return 0;
+}
+
+Eina_List *
+proc_info_fds_get(pid_t pid EINA_UNUSED, int64_t *limit)
+{
+   *limit = -1;
+
+   return NULL;
+}
+
+void
+proc_info_fds_clear(void)
+{
+}
+
+#endif
+
 Eina_List *
 proc_info_all_get(void)
 {
-   Eina_List *processes;
+   Eina_List *processes, *l;
+   Proc_Stats *p;
+   double timestamp = _proc_timestamp();
 
 #if defined(__linux__)
    processes = _process_list_linux_get();
@@ -563,6 +1813,9 @@ proc_info_all_get(void)
    processes = NULL;
 #endif
 
+   EINA_LIST_FOREACH(processes, l, p)
+     p->timestamp = timestamp;
+
    return processes;
 }
 
@@ -26,10 +26,51 @@
 
 #define CMD_NAME_MAX 256
 
+// The most NUMA nodes proc_info_numa_get() reports.
+#define PROC_NUMA_NODES_MAX 64
+
+// Seconds before proc_info_memory_get() reads a process again.
+#define PROC_MEMORY_REFRESH 15.0
+
+// Seconds before the cgroup of a process is read again, processes can be
+// moved. Every one is read again when PROC_INFO_FLAG_CGROUP is set.
+#define PROC_CGROUP_REFRESH 30.0
+
+typedef enum
+{
+   PROC_INFO_FLAG_NONE  = 0,
+   // Read /proc/<pid>/io for every process.
+   PROC_INFO_FLAG_IO    = (1 << 0),
+   // Read /proc/<pid>/schedstat for every process.
+   PROC_INFO_FLAG_SCHED = (1 << 1),
+   // Read the cgroup v2 path of every process, see PROC_CGROUP_REFRESH.
+   PROC_INFO_FLAG_CGROUP = (1 << 2),
+   // Read the namespaces and namespace pid of every process.
+   PROC_INFO_FLAG_NS    = (1 << 3),
+} Proc_Info_Flags;
+
+// Processes in the same pid, mount and network namespaces share one of
+// these, so two processes are in the same container when the pointers
+// are equal. They are freed two scans after no process is seen in them.
+typedef struct _Proc_Namespaces
+{
+   // Inode numbers of the namespaces.
+   uint64_t    pid;
+   uint64_t    mnt;
+   uint64_t    net;
+   // "pid:[n] mnt:[n] net:[n]", stringshared.
+   const char *name;
+   // Those of esysinfo itself.
+   Eina_Bool   host;
+} Proc_Namespaces;
+
 typedef struct _Proc_Stats
 {
    pid_t       pid;
+   pid_t       ppid;
    uid_t       uid;
+   // Opaque, distinguishes processes that share a recycled pid.
+   unsigned long long start_time;
    int8_t      nice;
    int8_t      priority;
    int         cpu_id;
@@ -37,13 +78,92 @@ typedef struct _Proc_Stats
    int64_t     mem_size;
    int64_t     mem_rss;
    double      cpu_usage;
+   uint64_t    minflt;
+   uint64_t    majflt;
+   double      minflt_rate;
+   double      majflt_rate;
    char        command[CMD_NAME_MAX];
    const char *state;
+   const char *user;
+
+   uint64_t    io_read_bytes;
+   uint64_t    io_write_bytes;
+   uint64_t    io_syscr;
+   uint64_t    io_syscw;
+   double      io_read_rate;
+   double      io_write_rate;
 
-   // Not used yet in UI.
-   long        cpu_time;
+   // Nanoseconds on CPU and waiting on a run queue.
+   uint64_t    sched_run_time;
+   uint64_t    sched_wait_time;
+   uint64_t    sched_timeslices;
+   // Milliseconds per second spent waiting to run.
+   double      sched_delay;
+
+   // Only valid when mem_detail is set, see proc_info_memory_get().
+   Eina_Bool   mem_detail;
+   int64_t     mem_pss;
+   int64_t     mem_uss;
+   int64_t     mem_swap;
+   int64_t     mem_anon_huge;
+
+   // Resident memory growth in bytes per hour, only valid when
+   // mem_growth_valid is set, see history_rss_growth_get().
+   Eina_Bool   mem_growth_valid;
+   double      mem_growth;
+
+   // cgroup v2 path, interned, see cgroup_path_intern(). NULL unless
+   // PROC_INFO_FLAG_CGROUP is set or where unsupported.
+   const char *cgroup;
+
+   // NULL unless PROC_INFO_FLAG_NS is set, or where unsupported or not
+   // permitted.
+   const Proc_Namespaces *ns;
+   // The pid as seen from inside its own pid namespace, 0 if unknown.
+   pid_t       ns_pid;
+
+   // User and system CPU time in microseconds.
+   int64_t     cpu_time;
+   // CLOCK_MONOTONIC seconds at which the process was read.
+   double      timestamp;
 } Proc_Stats;
 
+typedef struct _Proc_Thread
+{
+   pid_t       tid;
+   char        name[CMD_NAME_MAX];
+   const char *state;
+   // The CPU it last ran on.
+   int         cpu_id;
+   // Percent of one CPU since the previous proc_info_threads_get().
+   double      cpu_usage;
+   uint64_t    ctxt_voluntary;
+   uint64_t    ctxt_involuntary;
+} Proc_Thread;
+
+typedef struct _Proc_Fd
+{
+   int  fd;
+   // The link target, "pipe:[123]" and the like, with sockets described
+   // as "tcp 10.0.0.1:5432 -> 10.0.0.2:40000 ESTABLISHED" where found.
+   char target[];
+} Proc_Fd;
+
+/**
+ * Set which optional, more expensive, statistics are collected by
+ * proc_info_all_get().
+ *
+ * The files these read are kept open between polls, up to a few
+ * descriptors per process. The first time one is kept, the soft
+ * RLIMIT_NOFILE of the whole program is raised to its hard limit.
+ * Clearing PROC_INFO_FLAG_NS closes the /proc/<pid> directories kept
+ * for namespaces.
+ *
+ * @param flags A mask of Proc_Info_Flags.
+ */
+void
+proc_info_flags_set(unsigned int flags);
+
 /**
  * Query a full list of running processes and return a list.
  *
@@ -62,6 +182,81 @@ proc_info_all_get(void);
 Proc_Stats *
 proc_info_by_pid(int pid);
 
+/**
+ * Fill in the proportional memory statistics of a process: PSS, USS
+ * (private pages), swap and anonymous huge pages.
+ *
+ * These come from /proc/<pid>/smaps_rollup which is expensive for the
+ * kernel to generate, so values are cached per process and only read
+ * again once they are PROC_MEMORY_REFRESH seconds old. Callers should
+ * only refresh the processes they are actually showing.
+ *
+ * @param proc The process, its pid and start_time identify it.
+ * @param refresh Read the process if the cached values are missing or stale,
+ *                otherwise only use what is cached.
+ *
+ * @return EINA_TRUE if the process was read and its values may have changed.
+ */
+Eina_Bool
+proc_info_memory_get(Proc_Stats *proc, Eina_Bool refresh);
+
+/**
+ * Query the threads of a process.
+ *
+ * The task directory of the process and the stat and status files of
+ * each thread are kept open between calls for the same pid, along with
+ * the CPU time used to work out usage. State for threads that have
+ * exited is released on each call, and all of it when the pid changes.
+ *
+ * @param pid The process ID to query.
+ *
+ * @return A list of Proc_Thread, freed by the caller. NULL where
+ *         unsupported.
+ */
+Eina_List *
+proc_info_threads_get(pid_t pid);
+
+/**
+ * Release the state kept by proc_info_threads_get().
+ */
+void
+proc_info_threads_clear(void);
+
+/**
+ * Query where the pages of a process are, from /proc/<pid>/numa_maps.
+ * The kernel walks every mapping to produce it, so this is slow on large
+ * processes and is meant to be called on demand.
+ *
+ * @param pid The process ID to query.
+ * @param node_bytes Filled with the resident bytes on each node.
+ * @param max The size of node_bytes, at most PROC_NUMA_NODES_MAX.
+ *
+ * @return The number of nodes with pages, 0 where unsupported.
+ */
+int
+proc_info_numa_get(pid_t pid, uint64_t *node_bytes, int max);
+
+/**
+ * List the open file descriptors of a process. Sockets are described
+ * from an index of inodes built from the tcp, tcp6, udp, udp6 and unix
+ * tables of the process' network namespace. The index is built once per
+ * call, and only when the process has sockets.
+ *
+ * @param pid The process ID to query.
+ * @param limit Set to its soft RLIMIT_NOFILE, -1 if unknown or unlimited.
+ *
+ * @return A list of Proc_Fd by descriptor, freed by the caller. NULL
+ *         where unsupported.
+ */
+Eina_List *
+proc_info_fds_get(pid_t pid, int64_t *limit);
+
+/**
+ * Release the socket index and buffer kept by proc_info_fds_get().
+ */
+void
+proc_info_fds_clear(void);
+
 /**
  * @}
  */
@@ -30,6 +30,7 @@
 #include <ctype.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <errno.h>
@@ -40,9 +41,14 @@
 #include <sys/sysctl.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/stat.h>
 #include <net/if.h>
 #include <pthread.h>
 
+#include "system.h"
+
 #if defined(__APPLE__) && defined(__MACH__)
 #define __MacOS__
 # include <mach/mach.h>
@@ -66,6 +72,10 @@
 # include <vm/vm_param.h>
 #endif
 
+#if defined(__linux__)
+# include <linux/netlink.h>
+#endif
+
 #define CPU_STATES        5
 
 #define MAX_BATTERIES     5
@@ -90,16 +100,7 @@ typedef struct
    unsigned long idle;
 } cpu_core_t;
 
-typedef struct
-{
-   unsigned long total;
-   unsigned long used;
-   unsigned long cached;
-   unsigned long buffered;
-   unsigned long shared;
-   unsigned long swap_total;
-   unsigned long swap_used;
-} meminfo_t;
+typedef Sys_Memory meminfo_t;
 
 typedef struct
 {
@@ -110,7 +111,6 @@ typedef struct
    double  charge_current;
    uint8_t percent;
 
-   char    battery_names[256];
    int    *bat_mibs[MAX_BATTERIES];
    int     ac_mibs[5];
 } power_t;
@@ -146,39 +146,62 @@ _memsize_kb_to_gb(unsigned long *bytes)
 }
 
 #if defined(__linux__)
-static char *
-Fcontents(const char *path)
+// A /proc file kept open and read whole with pread() into a buffer that
+// is kept, and grown, between reads.
+typedef struct
 {
-   char *buf;
-   char byte[1];
-   size_t count, bytes = 0;
-   FILE *f = fopen(path, "r");
-   if (!f) return NULL;
+   const char *path;
+   int         fd;
+   char       *buf;
+   size_t      size;
+} proc_file_t;
+
+static ssize_t
+_proc_file_read(proc_file_t *file)
+{
+   ssize_t bytes;
+   char *tmp;
 
-   int n = 1024;
+   // Files missing from this kernel are only tried once.
+   if (file->fd == -1)
+     {
+        file->fd = open(file->path, O_RDONLY | O_CLOEXEC);
+        if (file->fd < 0)
+          file->fd = -2;
+     }
 
-   buf = malloc(n * sizeof(byte) + 1);
-   if (!buf) exit(0 << 1);
+   if (file->fd < 0)
+     return -1;
 
-   while ((count = (fread(byte, sizeof(byte), 1, f))) > 0)
+   while (1)
      {
-        bytes += sizeof(byte);
-        if (bytes == (n * sizeof(byte)))
+        if (!file->size)
           {
-             n *= 2;
-             char *tmp = realloc(buf, n * sizeof(byte) + 1);
-             if (!tmp) exit(1 << 1);
-             buf = tmp;
+             file->size = 4096;
+             file->buf = malloc(file->size);
+             if (!file->buf)
+               {
+                  file->size = 0;
+                  return -1;
+               }
           }
-        memcpy(&buf[bytes - sizeof(byte)], byte, sizeof(byte));
-     }
 
-   if (!feof(f)) exit(2 << 1);
-   fclose(f);
+        bytes = pread(file->fd, file->buf, file->size - 1, 0);
+        if (bytes < 0)
+          return -1;
 
-   buf[bytes] = 0;
+        if ((size_t) bytes < file->size - 1)
+          break;
+
+        tmp = realloc(file->buf, file->size * 2);
+        if (!tmp) return -1;
+        file->buf = tmp;
+        file->size *= 2;
+     }
+
+   file->buf[bytes] = '\0';
 
-   return buf;
+   return bytes;
 }
 
 #endif
@@ -201,42 +224,214 @@ _sysctlfromname(const char *name, void *mib, int depth, size_t *len)
 
 #endif
 
+#if !defined(__linux__)
 static int
 cpu_count(void)
 {
    int cores = 0;
+#if defined(__MacOS__) || defined(__FreeBSD__) || defined(__DragonFly__) || defined(__OpenBSD__) || defined(__NetBSD__)
+   size_t len;
+   int mib[2] = { CTL_HW, HW_NCPU };
+
+   len = sizeof(cores);
+   if (sysctl(mib, 2, &cores, &len, NULL, 0) < 0)
+     return 0;
+#endif
+   return cores;
+}
+
+#endif
+
 #if defined(__linux__)
-   char buf[4096];
-   FILE *f;
-   int line = 0;
+// Parse a "cpuN user nice system idle iowait irq softirq steal ..." line.
+// Kernels without the later states leave them at zero.
+static bool
+_cpu_line_parse(const char *line, int *id, uint64_t ticks[SYS_CPU_STATES])
+{
+   char *end;
+   int i;
 
-   f = fopen("/proc/stat", "r");
-   if (!f) return 0;
+   if (strncmp(line, "cpu", 3) || !isdigit((unsigned char) line[3]))
+     return false;
 
-   while (fgets(buf, sizeof(buf), f))
+   *id = strtol(line + 3, &end, 10);
+
+   for (i = 0; i < SYS_CPU_STATES; i++)
+     ticks[i] = strtoull(end, &end, 10);
+
+   return true;
+}
+
+enum
+{
+   ACTIVITY_CONTEXT_SWITCHES,
+   ACTIVITY_FORKS,
+   ACTIVITY_RUNNING,
+   ACTIVITY_BLOCKED,
+   ACTIVITY_SWAP_IN,
+   ACTIVITY_SWAP_OUT,
+   ACTIVITY_MAJOR_FAULTS,
+   ACTIVITY_PAGES_SCANNED,
+   ACTIVITY_COUNTERS,
+};
+
+// Keys of /proc/stat and /proc/vmstat, several may add up to a counter.
+static const struct
+{
+   const char *key;
+   int         counter;
+} _activity_keys[] = {
+   { "ctxt", ACTIVITY_CONTEXT_SWITCHES },
+   { "processes", ACTIVITY_FORKS },
+   { "procs_running", ACTIVITY_RUNNING },
+   { "procs_blocked", ACTIVITY_BLOCKED },
+   { "pswpin", ACTIVITY_SWAP_IN },
+   { "pswpout", ACTIVITY_SWAP_OUT },
+   { "pgmajfault", ACTIVITY_MAJOR_FAULTS },
+   { "pgscan_kswapd", ACTIVITY_PAGES_SCANNED },
+   { "pgscan_direct", ACTIVITY_PAGES_SCANNED },
+   { "pgscan_khugepaged", ACTIVITY_PAGES_SCANNED },
+};
+
+#define ACTIVITY_KEYS  (sizeof(_activity_keys) / sizeof(_activity_keys[0]))
+// Open addressing, a power of two well above the number of keys.
+#define ACTIVITY_SLOTS 64
+
+static signed char  _activity_slots[ACTIVITY_SLOTS];
+static bool         _activity_slots_built = false;
+
+// FNV-1a of a key, which ends at a space.
+static unsigned int
+_activity_hash(const char *key, size_t *len)
+{
+   unsigned int hash = 2166136261u;
+   const char *p;
+
+   for (p = key; *p && *p != ' ' && *p != '\n'; p++)
+     hash = (hash ^ (unsigned char) *p) * 16777619u;
+
+   *len = p - key;
+
+   return hash;
+}
+
+static void
+_activity_slots_build(void)
+{
+   unsigned int slot;
+   size_t i, len;
+
+   memset(_activity_slots, -1, sizeof(_activity_slots));
+
+   for (i = 0; i < ACTIVITY_KEYS; i++)
+     {
+        slot = _activity_hash(_activity_keys[i].key, &len) & (ACTIVITY_SLOTS - 1);
+        while (_activity_slots[slot] != -1)
+          slot = (slot + 1) & (ACTIVITY_SLOTS - 1);
+        _activity_slots[slot] = i;
+     }
+
+   _activity_slots_built = true;
+}
+
+// Add the value of a "key value" line to its counter, if the key is known.
+static void
+_activity_line(const char *line, unsigned long long counters[ACTIVITY_COUNTERS])
+{
+   unsigned int slot;
+   size_t len;
+   int i;
+
+   slot = _activity_hash(line, &len) & (ACTIVITY_SLOTS - 1);
+
+   for (; (i = _activity_slots[slot]) != -1; slot = (slot + 1) & (ACTIVITY_SLOTS - 1))
      {
-        if (line)
+        if (strlen(_activity_keys[i].key) == len && !strncmp(_activity_keys[i].key, line, len))
           {
-             if (!strncmp(buf, "cpu", 3))
-               cores++;
-             else
-               break;
+             counters[_activity_keys[i].counter] += strtoull(line + len, NULL, 10);
+             break;
           }
-        line++;
      }
+}
 
-   fclose(f);
-#elif defined(__MacOS__) || defined(__FreeBSD__) || defined(__DragonFly__) || defined(__OpenBSD__) || defined(__NetBSD__)
-   size_t len;
-   int mib[2] = { CTL_HW, HW_NCPU };
+// One pass over "key value" lines, adding the values of known keys.
+static void
+_activity_parse(const char *buf, unsigned long long counters[ACTIVITY_COUNTERS])
+{
+   const char *line;
 
-   len = sizeof(cores);
-   if (sysctl(mib, 2, &cores, &len, NULL, 0) < 0)
-     return 0;
-#endif
-   return cores;
+   for (line = buf; line && *line; line = strchr(line, '\n'), line = line ? line + 1 : NULL)
+     _activity_line(line, counters);
+}
+
+// /proc/stat is read once per tick, into the CPU times and the activity
+// counters of its other lines. Each reader has its own generation seen,
+// so the first one to come back for more data reads the file again and
+// the others use that read.
+static proc_file_t         _stat = { "/proc/stat", -1, NULL, 0 };
+static Sys_Cpu            *_stat_cpus = NULL;
+static int                 _stat_cpus_count = 0;
+static int                 _stat_cpus_size = 0;
+static unsigned long long  _stat_counters[ACTIVITY_COUNTERS];
+static unsigned int        _stat_generation = 0;
+
+static bool
+_stat_read(void)
+{
+   uint64_t ticks[SYS_CPU_STATES];
+   Sys_Cpu *tmp;
+   char *line;
+   int id;
+
+   if (_proc_file_read(&_stat) <= 0)
+     return false;
+
+   if (!_activity_slots_built)
+     _activity_slots_build();
+
+   _stat_cpus_count = 0;
+   memset(_stat_counters, 0, sizeof(_stat_counters));
+
+   for (line = _stat.buf; line && *line; line = strchr(line, '\n'), line = line ? line + 1 : NULL)
+     {
+        if (!_cpu_line_parse(line, &id, ticks))
+          {
+             _activity_line(line, _stat_counters);
+             continue;
+          }
+
+        if (_stat_cpus_count == _stat_cpus_size)
+          {
+             tmp = realloc(_stat_cpus, (_stat_cpus_size + 16) * sizeof(Sys_Cpu));
+             if (!tmp) continue;
+             _stat_cpus = tmp;
+             _stat_cpus_size += 16;
+          }
+
+        _stat_cpus[_stat_cpus_count].id = id;
+        memcpy(_stat_cpus[_stat_cpus_count].ticks, ticks, sizeof(ticks));
+        _stat_cpus_count++;
+     }
+
+   _stat_generation++;
+
+   return true;
+}
+
+// The latest read of /proc/stat, read again if this reader saw it already.
+static bool
+_stat_get(unsigned int *seen)
+{
+   if (*seen == _stat_generation && !_stat_read())
+     return false;
+
+   *seen = _stat_generation;
+
+   return true;
 }
 
+#endif
+
 static void
 _cpu_state_get(cpu_core_t **cores, int ncpu)
 {
@@ -351,44 +546,40 @@ _cpu_state_get(cpu_core_t **cores, int ncpu)
           }
      }
 #elif defined(__linux__)
-   char *buf, name[128];
-   int i;
+   const Sys_Cpu *cpu;
+   int i, n;
 
-   buf = Fcontents("/proc/stat");
-   if (!buf) return;
+   // From the last read of /proc/stat. Cores are indexed by number, so
+   // one going offline doesn't shift the others. Waiting on I/O is idle.
+   for (n = 0; n < _stat_cpus_count; n++)
+     {
+        cpu = &_stat_cpus[n];
+        if (cpu->id >= ncpu)
+          continue;
 
-   for (i = 0; i < ncpu; i++) {
-        core = cores[i];
-        snprintf(name, sizeof(name), "cpu%d", i);
-        char *line = strstr(buf, name);
-        if (line)
-          {
-             line = strchr(line, ' ') + 1;
-             unsigned long cpu_times[4] = { 0 };
+        core = cores[cpu->id];
 
-             if (4 != sscanf(line, "%lu %lu %lu %lu", &cpu_times[0], &cpu_times[1], &cpu_times[2], &cpu_times[3]))
-               return;
+        total = 0;
+        for (i = 0; i < SYS_CPU_STATES; i++)
+          total += cpu->ticks[i];
+        idle = cpu->ticks[SYS_CPU_IDLE] + cpu->ticks[SYS_CPU_IOWAIT];
 
-             total = cpu_times[0] + cpu_times[1] + cpu_times[2] + cpu_times[3];
-             idle = cpu_times[3];
-             diff_total = total - core->total;
-             if (diff_total == 0) diff_total = 1;
+        diff_total = total - core->total;
+        if (diff_total == 0) diff_total = 1;
 
-             diff_idle = idle - core->idle;
-             ratio = diff_total / 100.0;
-             used = diff_total - diff_idle;
-             percent = used / ratio;
+        diff_idle = idle - core->idle;
+        ratio = diff_total / 100.0;
+        used = diff_total - diff_idle;
+        percent = used / ratio;
 
-             if (percent > 100) percent = 100;
-             else if (percent < 0)
-               percent = 0;
+        if (percent > 100) percent = 100;
+        else if (percent < 0)
+          percent = 0;
 
-             core->percent = percent;
-             core->total = total;
-             core->idle = idle;
-          }
+        core->percent = percent;
+        core->total = total;
+        core->idle = idle;
      }
-   free(buf);
 #elif defined(__MacOS__)
    mach_msg_type_number_t count;
    processor_cpu_load_info_t load;
@@ -427,6 +618,7 @@ _cpu_state_get(cpu_core_t **cores, int ncpu)
 #endif
 }
 
+#if !defined(__linux__)
 static cpu_core_t **
 _cpu_cores_state_get(int *ncpu)
 {
@@ -447,18 +639,143 @@ _cpu_cores_state_get(int *ncpu)
    return cores;
 }
 
+#else
+// Cores by number, kept so that each call measures since the last one.
+static cpu_core_t  **_cores = NULL;
+static int           _cores_count = 0;
+static unsigned int  _cores_seen = 0;
+
+// Average use of the online cores, returns how many there are.
+static int
+_cpu_usage_get(double *percent)
+{
+   cpu_core_t **tmp;
+   double total = 0;
+   int i, ncpu = 0;
+
+   *percent = 0;
+
+   if (!_stat_get(&_cores_seen))
+     return 0;
+
+   for (i = 0; i < _stat_cpus_count; i++)
+     {
+        if (_stat_cpus[i].id >= ncpu)
+          ncpu = _stat_cpus[i].id + 1;
+     }
+
+   if (ncpu > _cores_count)
+     {
+        tmp = realloc(_cores, ncpu * sizeof(cpu_core_t *));
+        if (!tmp) return 0;
+        _cores = tmp;
+
+        for (; _cores_count < ncpu; _cores_count++)
+          {
+             _cores[_cores_count] = calloc(1, sizeof(cpu_core_t));
+             if (!_cores[_cores_count])
+               return 0;
+          }
+     }
+
+   _cpu_state_get(_cores, _cores_count);
+
+   if (!_stat_cpus_count)
+     return 0;
+
+   for (i = 0; i < _stat_cpus_count; i++)
+     total += _cores[_stat_cpus[i].id]->percent;
+
+   *percent = total / _stat_cpus_count;
+
+   return _stat_cpus_count;
+}
+
+#endif
+
 #if defined(__linux__)
-static unsigned long
-_meminfo_parse_line(const char *line)
+// Keys of /proc/meminfo and the nodes' meminfo, sorted for bsearch(),
+// and where they go. Values are in kilobytes except for the huge page
+// counts.
+typedef struct
+{
+   const char *key;
+   size_t      offset;
+} meminfo_key_t;
+
+static const meminfo_key_t _meminfo_keys[] = {
+   { "AnonPages", offsetof(meminfo_t, anon) },
+   { "Buffers", offsetof(meminfo_t, buffered) },
+   { "Cached", offsetof(meminfo_t, cached) },
+   { "Dirty", offsetof(meminfo_t, dirty) },
+   // A node's page cache, it has no Cached.
+   { "FilePages", offsetof(meminfo_t, cached) },
+   { "HugePages_Free", offsetof(meminfo_t, huge_free) },
+   { "HugePages_Total", offsetof(meminfo_t, huge_total) },
+   { "Hugepagesize", offsetof(meminfo_t, huge_size) },
+   { "MemAvailable", offsetof(meminfo_t, available) },
+   { "MemFree", offsetof(meminfo_t, free) },
+   { "MemTotal", offsetof(meminfo_t, total) },
+   { "SReclaimable", offsetof(meminfo_t, slab_reclaimable) },
+   { "Shmem", offsetof(meminfo_t, shared) },
+   { "Slab", offsetof(meminfo_t, slab) },
+   { "SwapFree", offsetof(meminfo_t, swap_free) },
+   { "SwapTotal", offsetof(meminfo_t, swap_total) },
+   { "Writeback", offsetof(meminfo_t, writeback) },
+};
+
+static proc_file_t _meminfo = { "/proc/meminfo", -1, NULL, 0 };
+
+static int
+_meminfo_key_cmp(const void *key, const void *item)
+{
+   const char *line = key;
+   const char *name = ((const meminfo_key_t *) item)->key;
+   size_t len = strcspn(line, ":");
+   int cmp;
+
+   cmp = strncmp(line, name, len);
+   if (cmp) return cmp;
+
+   // The line's key is a prefix of the name.
+   return name[len] ? -1 : 0;
+}
+
+// Parse meminfo lines, "Node 0 " prefixes and all. Returns true if
+// MemAvailable was there.
+static bool
+_meminfo_parse(const char *buf, meminfo_t *memory)
 {
-   char *p, *tok;
+   const meminfo_key_t *found;
+   const char *line, *key;
+   bool have_available = false;
+   char *end;
 
-   p = strchr(line, ':') + 1;
-   while (isspace(*p))
-     p++;
-   tok = strtok(p, " ");
+   for (line = buf; *line; line = end + (*end == '\n'))
+     {
+        end = strchr(line, '\n');
+        if (!end) end = (char *) line + strlen(line);
+
+        key = line;
+        if (!strncmp(key, "Node ", 5))
+          {
+             key = strchr(key + 5, ' ');
+             if (!key || key > end) continue;
+             key++;
+          }
+
+        found = bsearch(key, _meminfo_keys, sizeof(_meminfo_keys) / sizeof(_meminfo_keys[0]),
+                        sizeof(_meminfo_keys[0]), _meminfo_key_cmp);
+        if (!found) continue;
+
+        if (found->offset == offsetof(meminfo_t, available))
+          have_available = true;
+
+        *(unsigned long *) ((char *) memory + found->offset) =
+          strtoul(key + strlen(found->key) + 1, NULL, 10);
+     }
 
-   return atol(tok);
+   return have_available;
 }
 
 #endif
@@ -472,66 +789,21 @@ _memory_usage_get(meminfo_t *memory)
 #endif
    memset(memory, 0, sizeof(meminfo_t));
 #if defined(__linux__)
-   FILE *f;
-   unsigned long swap_free = 0, tmp_free = 0, tmp_slab = 0;
-   char line[256];
-   int fields = 0;
-
-   f = fopen("/proc/meminfo", "r");
-   if (!f) return;
-
-   while (fgets(line, sizeof(line), f) != NULL)
-     {
-        if (!strncmp("MemTotal:", line, 9))
-          {
-             memory->total = _meminfo_parse_line(line);
-             fields++;
-          }
-        else if (!strncmp("MemFree:", line, 8))
-          {
-             tmp_free = _meminfo_parse_line(line);
-             fields++;
-          }
-        else if (!strncmp("Cached:", line, 7))
-          {
-             memory->cached = _meminfo_parse_line(line);
-             fields++;
-          }
-        else if (!strncmp("Slab:", line, 5))
-          {
-             tmp_slab = _meminfo_parse_line(line);
-             fields++;
-          }
-        else if (!strncmp("Buffers:", line, 8))
-          {
-             memory->buffered = _meminfo_parse_line(line);
-             fields++;
-          }
-        else if (!strncmp("Shmem:", line, 6))
-          {
-             memory->shared = _meminfo_parse_line(line);
-             fields++;
-          }
-        else if (!strncmp("SwapTotal:", line, 10))
-          {
-             memory->swap_total = _meminfo_parse_line(line);
-             fields++;
-          }
-        else if (!strncmp("SwapFree:", line, 9))
-          {
-             swap_free = _meminfo_parse_line(line);
-             fields++;
-          }
+   bool have_available;
 
-        if (fields >= 8)
-          break;
-     }
+   if (_proc_file_read(&_meminfo) <= 0) return;
 
-   memory->cached += tmp_slab;
-   memory->used = memory->total - tmp_free - memory->cached - memory->buffered;
-   memory->swap_used = memory->swap_total = swap_free;
+   have_available = _meminfo_parse(_meminfo.buf, memory);
 
-   fclose(f);
+   memory->cached += memory->slab_reclaimable;
+   // Before 3.14 there is no MemAvailable, estimate it as the kernel did.
+   if (!have_available)
+     memory->available = memory->free + memory->cached + memory->buffered;
+   if (memory->available > memory->total)
+     memory->available = memory->total;
+   memory->used = memory->total - memory->available;
+   if (memory->swap_free < memory->swap_total)
+     memory->swap_used = memory->swap_total - memory->swap_free;
 #elif defined(__FreeBSD__) || defined(__DragonFly__)
    int total_pages = 0, free_pages = 0, inactive_pages = 0;
    long int result = 0;
@@ -694,51 +966,403 @@ swap_out:
         memory->swap_used = xsu.xsu_used;
      }
 #endif
+#if !defined(__linux__)
+   if (memory->used < memory->total)
+     memory->available = memory->total - memory->used;
+#endif
 }
 
-static void
-_temperature_cpu_get(int *temperature)
+#if defined(__linux__)
+// Kernel uevents, read to notice devices coming and going. Readers take
+// the subsystems they care about, the rest stays pending.
+enum
 {
-#if defined(__OpenBSD__) || defined(__NetBSD__)
-   int mibs[5] = { CTL_HW, HW_SENSORS, 0, 0, 0 };
-   int devn, numt;
-   struct sensor snsr;
-   size_t slen = sizeof(struct sensor);
-   struct sensordev snsrdev;
-   size_t sdlen = sizeof(struct sensordev);
+   UEVENT_SENSORS = (1 << 0),
+   UEVENT_POWER   = (1 << 1),
+   UEVENT_NODES   = (1 << 2),
+};
 
-   for (devn = 0;; devn++) {
-        mibs[2] = devn;
+static const struct
+{
+   const char  *subsystem;
+   unsigned int mask;
+} _uevent_subsystems[] = {
+   { "SUBSYSTEM=hwmon", UEVENT_SENSORS },
+   { "SUBSYSTEM=thermal", UEVENT_SENSORS },
+   { "SUBSYSTEM=cpu", UEVENT_SENSORS },
+   { "SUBSYSTEM=cpu", UEVENT_NODES },
+   { "SUBSYSTEM=node", UEVENT_NODES },
+   { "SUBSYSTEM=power_supply", UEVENT_POWER },
+};
 
-        if (sysctl(mibs, 3, &snsrdev, &sdlen, NULL, 0) == -1)
-          {
-             if (errno == ENOENT)
-               break;
-             else
-               continue;
-          }
-        if (!strcmp("cpu0", snsrdev.xname))
-          break;
-        else if (!strcmp("km0", snsrdev.xname))
-          break;
-     }
+static int          _uevent_fd = -2;
+static unsigned int _uevent_pending = 0;
 
-   for (numt = 0; numt < snsrdev.maxnumt[SENSOR_TEMP]; numt++) {
-        mibs[4] = numt;
+// Returns which of mask had a device added or removed since last taken.
+static unsigned int
+_uevent_take(unsigned int mask)
+{
+   struct sockaddr_nl addr;
+   char buf[8192];
+   ssize_t bytes;
+   unsigned int taken;
+   char *p;
+   int i;
 
-        if (sysctl(mibs, 5, &snsr, &slen, NULL, 0) == -1)
-          continue;
+   if (_uevent_fd == -2)
+     {
+        _uevent_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+        if (_uevent_fd < 0) return 0;
 
-        if (slen > 0 && (snsr.flags & SENSOR_FINVALID) == 0)
-          break;
+        memset(&addr, 0, sizeof(addr));
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = 1;
+        if (bind(_uevent_fd, (struct sockaddr *) &addr, sizeof(addr)) < 0)
+          {
+             close(_uevent_fd);
+             _uevent_fd = -1;
+          }
+        return 0;
      }
 
-   if (sysctl(mibs, 5, &snsr, &slen, NULL, 0)
-       != -1)
+   if (_uevent_fd < 0) return 0;
+
+   // "add@/devices/...\0ACTION=add\0DEVPATH=...\0SUBSYSTEM=hwmon\0..."
+   while ((bytes = recv(_uevent_fd, buf, sizeof(buf) - 1, MSG_DONTWAIT)) > 0)
      {
-        *temperature = (snsr.value - 273150000) / 1000000.0;
+        buf[bytes] = '\0';
+        for (p = buf; p < buf + bytes; p += strlen(p) + 1)
+          {
+             for (i = 0; i < (int) (sizeof(_uevent_subsystems) / sizeof(_uevent_subsystems[0])); i++)
+               {
+                  if (!strcmp(p, _uevent_subsystems[i].subsystem))
+                    _uevent_pending |= _uevent_subsystems[i].mask;
+               }
+          }
      }
-   else
+
+   taken = _uevent_pending & mask;
+   _uevent_pending &= ~mask;
+
+   return taken;
+}
+
+// A temperature input found under /sys/class/thermal or /sys/class/hwmon,
+// kept open. Values are in millidegrees Celsius.
+typedef struct
+{
+   char name[64];
+   int  socket;
+   int  fd;
+} sensor_t;
+
+static sensor_t *_sensors = NULL;
+static int       _sensors_count = 0;
+static bool      _sensors_found = false;
+
+// Read a one line sysfs attribute without its newline.
+static bool
+_sysfs_line_read(int dir_fd, const char *name, char *buf, size_t size)
+{
+   ssize_t bytes;
+   int fd;
+
+   fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+   if (fd < 0) return false;
+
+   bytes = read(fd, buf, size - 1);
+   close(fd);
+
+   if (bytes <= 0) return false;
+   buf[bytes] = '\0';
+   buf[strcspn(buf, "\n")] = '\0';
+
+   return true;
+}
+
+static void
+_sensor_add(int dir_fd, const char *input, const char *name, int socket)
+{
+   sensor_t *tmp;
+   int fd;
+
+   fd = openat(dir_fd, input, O_RDONLY | O_CLOEXEC);
+   if (fd < 0) return;
+
+   tmp = realloc(_sensors, (_sensors_count + 1) * sizeof(sensor_t));
+   if (!tmp)
+     {
+        close(fd);
+        return;
+     }
+   _sensors = tmp;
+
+   snprintf(_sensors[_sensors_count].name, sizeof(_sensors[0].name), "%s", name);
+   _sensors[_sensors_count].socket = socket;
+   _sensors[_sensors_count].fd = fd;
+   _sensors_count++;
+}
+
+static void
+_sensors_clear(void)
+{
+   for (int i = 0; i < _sensors_count; i++)
+     close(_sensors[i].fd);
+
+   free(_sensors);
+   _sensors = NULL;
+   _sensors_count = 0;
+}
+
+// Names here are a prefix and a number, "hwmon2" comes before "hwmon10".
+static int
+_sysfs_name_cmp(const struct dirent **a, const struct dirent **b)
+{
+   size_t len_a = strlen((*a)->d_name), len_b = strlen((*b)->d_name);
+
+   if (len_a != len_b)
+     return len_a < len_b ? -1 : 1;
+
+   return strcmp((*a)->d_name, (*b)->d_name);
+}
+
+static int
+_thermal_zone_filter(const struct dirent *dh)
+{
+   return !strncmp(dh->d_name, "thermal_zone", 12);
+}
+
+static int
+_hwmon_filter(const struct dirent *dh)
+{
+   return !strncmp(dh->d_name, "hwmon", 5);
+}
+
+static int
+_hwmon_input_filter(const struct dirent *dh)
+{
+   size_t len = strlen(dh->d_name);
+
+   return !strncmp(dh->d_name, "temp", 4) && len > 6 && !strcmp(dh->d_name + len - 6, "_input");
+}
+
+static void
+_sensors_thermal_find(void)
+{
+   struct dirent **zones;
+   char path[PATH_MAX], type[64];
+   int i, n, dir_fd, socket, packages = 0;
+
+   n = scandir("/sys/class/thermal", &zones, _thermal_zone_filter, _sysfs_name_cmp);
+   if (n < 0) return;
+
+   for (i = 0; i < n; i++)
+     {
+        snprintf(path, sizeof(path), "/sys/class/thermal/%s", zones[i]->d_name);
+        dir_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd < 0) continue;
+
+        if (_sysfs_line_read(dir_fd, "type", type, sizeof(type)))
+          {
+             // One package zone per socket, in order.
+             if (strstr(type, "_pkg_temp"))
+               socket = packages++;
+             else if (strstr(type, "cpu"))
+               socket = 0;
+             else
+               socket = -1;
+
+             _sensor_add(dir_fd, "temp", type, socket);
+          }
+
+        close(dir_fd);
+     }
+
+   for (i = 0; i < n; i++)
+     free(zones[i]);
+   free(zones);
+}
+
+static void
+_sensors_hwmon_chip_find(const char *path, int dir_fd, const char *chip, int socket)
+{
+   struct dirent **inputs;
+   char label_file[64], label[32], name[64];
+   int i, n, index;
+
+   n = scandir(path, &inputs, _hwmon_input_filter, _sysfs_name_cmp);
+   if (n < 0) return;
+
+   for (i = 0; i < n; i++)
+     {
+        if (sscanf(inputs[i]->d_name, "temp%d_input", &index) != 1)
+          continue;
+
+        snprintf(label_file, sizeof(label_file), "temp%d_label", index);
+        if (!_sysfs_line_read(dir_fd, label_file, label, sizeof(label)))
+          snprintf(label, sizeof(label), "temp%d", index);
+
+        snprintf(name, sizeof(name), "%s %s", chip, label);
+        _sensor_add(dir_fd, inputs[i]->d_name, name, socket);
+     }
+
+   for (i = 0; i < n; i++)
+     free(inputs[i]);
+   free(inputs);
+}
+
+static void
+_sensors_hwmon_find(void)
+{
+   struct dirent **chips;
+   char path[PATH_MAX], link[PATH_MAX], device[PATH_MAX], chip[32], *base;
+   int i, n, dir_fd, socket, amd = 0;
+
+   n = scandir("/sys/class/hwmon", &chips, _hwmon_filter, _sysfs_name_cmp);
+   if (n < 0) return;
+
+   for (i = 0; i < n; i++)
+     {
+        snprintf(path, sizeof(path), "/sys/class/hwmon/%s", chips[i]->d_name);
+        dir_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd < 0) continue;
+
+        if (!_sysfs_line_read(dir_fd, "name", chip, sizeof(chip)))
+          {
+             close(dir_fd);
+             continue;
+          }
+
+        if (snprintf(link, sizeof(link), "%s/device", path) >= (int) sizeof(link) ||
+            !realpath(link, device))
+          device[0] = '\0';
+        base = strrchr(device, '/');
+
+        // Thermal zones register themselves here too, they are already in.
+        if (strstr(device, "/thermal_zone"))
+          {
+             close(dir_fd);
+             continue;
+          }
+
+        // coretemp is one platform device per package, "coretemp.N". AMD
+        // has one PCI function per node, listed in order.
+        socket = -1;
+        if (!strcmp(chip, "coretemp"))
+          {
+             if (!base || sscanf(base, "/coretemp.%d", &socket) != 1)
+               socket = 0;
+          }
+        else if (!strcmp(chip, "k10temp") || !strcmp(chip, "zenpower"))
+          socket = amd++;
+
+        _sensors_hwmon_chip_find(path, dir_fd, chip, socket);
+        close(dir_fd);
+     }
+
+   for (i = 0; i < n; i++)
+     free(chips[i]);
+   free(chips);
+}
+
+static Sys_Sensor *
+_sensors_read(int *count)
+{
+   Sys_Sensor *sensors;
+   char buf[32];
+   ssize_t bytes;
+   int i, n = 0;
+
+   if (_uevent_take(UEVENT_SENSORS) || !_sensors_found)
+     {
+        _sensors_clear();
+        _sensors_thermal_find();
+        _sensors_hwmon_find();
+        _sensors_found = true;
+     }
+
+   sensors = malloc((_sensors_count ? _sensors_count : 1) * sizeof(Sys_Sensor));
+   if (!sensors)
+     {
+        *count = 0;
+        return NULL;
+     }
+
+   for (i = 0; i < _sensors_count; i++)
+     {
+        bytes = pread(_sensors[i].fd, buf, sizeof(buf) - 1, 0);
+        if (bytes <= 0)
+          {
+             // Gone without a uevent, look again next time.
+             if (bytes < 0 && errno != EAGAIN)
+               _sensors_found = false;
+             continue;
+          }
+        buf[bytes] = '\0';
+
+        snprintf(sensors[n].name, sizeof(sensors[n].name), "%s", _sensors[i].name);
+        sensors[n].socket = _sensors[i].socket;
+        sensors[n].temperature = atoi(buf) / 1000.0;
+        n++;
+     }
+
+   *count = n;
+
+   if (!n)
+     {
+        free(sensors);
+        return NULL;
+     }
+
+   return sensors;
+}
+
+#endif
+
+#if !defined(__linux__)
+static void
+_temperature_cpu_get(int *temperature)
+{
+#if defined(__OpenBSD__) || defined(__NetBSD__)
+   int mibs[5] = { CTL_HW, HW_SENSORS, 0, 0, 0 };
+   int devn, numt;
+   struct sensor snsr;
+   size_t slen = sizeof(struct sensor);
+   struct sensordev snsrdev;
+   size_t sdlen = sizeof(struct sensordev);
+
+   for (devn = 0;; devn++) {
+        mibs[2] = devn;
+
+        if (sysctl(mibs, 3, &snsrdev, &sdlen, NULL, 0) == -1)
+          {
+             if (errno == ENOENT)
+               break;
+             else
+               continue;
+          }
+        if (!strcmp("cpu0", snsrdev.xname))
+          break;
+        else if (!strcmp("km0", snsrdev.xname))
+          break;
+     }
+
+   for (numt = 0; numt < snsrdev.maxnumt[SENSOR_TEMP]; numt++) {
+        mibs[4] = numt;
+
+        if (sysctl(mibs, 5, &snsr, &slen, NULL, 0) == -1)
+          continue;
+
+        if (slen > 0 && (snsr.flags & SENSOR_FINVALID) == 0)
+          break;
+     }
+
+   if (sysctl(mibs, 5, &snsr, &slen, NULL, 0)
+       != -1)
+     {
+        *temperature = (snsr.value - 273150000) / 1000000.0;
+     }
+   else
      *temperature = INVALID_TEMP;
 #elif defined(__FreeBSD__) || defined(__DragonFly__)
    unsigned int value;
@@ -751,48 +1375,14 @@ _temperature_cpu_get(int *temperature)
      }
    else
      *temperature = INVALID_TEMP;
-#elif defined(__linux__)
-   struct dirent *dh;
-   DIR *dir;
-   char path[PATH_MAX];
-
-   *temperature = INVALID_TEMP;
-
-   dir = opendir("/sys/class/thermal");
-   if (!dir) return;
-
-   while ((dh = readdir(dir)) != NULL)
-     {
-        if (!strncmp(dh->d_name, "thermal_zone", 12))
-          {
-             snprintf(path, sizeof(path), "/sys/class/thermal/%s/type", dh->d_name);
-             char *type = Fcontents(path);
-             if (type)
-               {
-                  /* This should ensure we get the highest available core temperature */
-                  if (strstr(type, "_pkg_temp"))
-                    {
-                       snprintf(path, sizeof(path), "/sys/class/thermal/%s/temp", dh->d_name);
-                       char *value = Fcontents(path);
-                       if (value)
-                         {
-                            *temperature = atoi(value) / 1000;
-                            free(value);
-                            free(type);
-                            break;
-                         }
-                    }
-                  free(type);
-               }
-          }
-     }
-
-   closedir(dir);
 #elif defined(__MacOS__)
    *temperature = INVALID_TEMP;
 #endif
 }
 
+#endif
+
+#if !defined(__linux__)
 static int
 _power_battery_count_get(power_t *power)
 {
@@ -846,23 +1436,6 @@ _power_battery_count_get(power_t *power)
      {
         sysctlnametomib("hw.acpi.acline", power->ac_mibs, &len);
      }
-#elif defined(__linux__)
-   struct dirent *dh;
-   DIR *dir;
-
-   dir = opendir("/sys/class/power_supply");
-   if (!dir) return 0;
-
-   while ((dh = readdir(dir)) != NULL)
-     {
-        if (dh->d_name[0] == '.') continue;
-        if (!strncmp(dh->d_name, "BAT", 3))
-          {
-             power->battery_names[power->battery_count++] = (char)dh->d_name[3];
-          }
-     }
-
-   closedir(dir);
 #endif
    return power->battery_count;
 }
@@ -911,52 +1484,6 @@ _battery_state_get(power_t *power, int *mib)
    size_t len = sizeof(value);
    if ((sysctl(mib, 4, &value, &len, NULL, 0)) != -1)
      power->percent = value;
-#elif defined(__linux__)
-   char path[PATH_MAX];
-   struct dirent *dh;
-   DIR *dir;
-   char *buf, *naming = NULL;
-   int i = 0;
-   unsigned long charge_full = 0;
-   unsigned long charge_current = 0;
-
-   while (power->battery_names[i] != '\0')
-     {
-        snprintf(path, sizeof(path), "/sys/class/power_supply/BAT%c", power->battery_names[i]);
-        dir = opendir(path);
-        if (!dir) return;
-        while ((dh = readdir(dir)) != NULL)
-          {
-             if (!strcmp(dh->d_name, "energy_full"))
-               {
-                  naming = "energy"; break;
-               }
-             else if (!strcmp(dh->d_name, "capacity_full"))
-               {
-                  naming = "capacity"; break;
-               }
-          }
-        closedir(dir);
-        if (!naming) continue;
-        snprintf(path, sizeof(path), "/sys/class/power_supply/BAT%c/%s_full", power->battery_names[i], naming);
-        buf = Fcontents(path);
-        if (buf)
-          {
-             charge_full = atol(buf);
-             free(buf);
-          }
-        snprintf(path, sizeof(path), "/sys/class/power_supply/BAT%c/%s_now", power->battery_names[i], naming);
-        buf = Fcontents(path);
-        if (buf)
-          {
-             charge_current = atol(buf);
-             free(buf);
-          }
-        power->charge_full += charge_full;
-        power->charge_current += charge_current;
-        naming = NULL;
-        i++;
-     }
 #endif
 }
 
@@ -971,9 +1498,6 @@ _power_state_get(power_t *power)
 #elif defined(__FreeBSD__) || defined(__DragonFly__)
    unsigned int value;
    size_t len;
-#elif defined(__linux__)
-   char *buf;
-   int have_ac = 0;
 #endif
 
 #if defined(__OpenBSD__) || defined(__NetBSD__)
@@ -989,19 +1513,12 @@ _power_state_get(power_t *power)
         return;
      }
    power->have_ac = value;
-#elif defined(__linux__)
-   buf = Fcontents("/sys/class/power_supply/AC/online");
-   if (buf)
-     {
-        have_ac = atoi(buf);
-        free(buf);
-     }
 #endif
 
    for (i = 0; i < power->battery_count; i++)
      _battery_state_get(power, power->bat_mibs[i]);
 
-#if defined(__OpenBSD__) || defined(__NetBSD__) || defined(__linux__)
+#if defined(__OpenBSD__) || defined(__NetBSD__)
    double percent =
      100 * (power->charge_current / power->charge_full);
 
@@ -1021,53 +1538,322 @@ _power_state_get(power_t *power)
      if (power->bat_mibs[i]) free(power->bat_mibs[i]);
 }
 
-#if defined(__MacOS__) || defined(__FreeBSD__) || defined(__DragonFly__)
-static void
-_freebsd_generic_network_status(unsigned long int *in,
-                                unsigned long int *out)
+#endif
+
+#if defined(__linux__)
+// A power supply found under /sys/class/power_supply. Attributes are kept
+// open, -1 when missing.
+typedef struct
 {
-   struct ifmibdata *ifmd;
-   size_t len;
-   int i, count;
-   len = sizeof(count);
+   char name[NAME_MAX + 1];
+   bool mains;
+   // Mains.
+   int  online;
+   // Batteries. now, full and rate are energy_now, energy_full and
+   // power_now in µWh and µW, or charge_now, charge_full and current_now
+   // in µAh and µA, turned into energy with voltage_now.
+   bool charge;
+   int  status;
+   int  capacity;
+   int  now;
+   int  full;
+   int  rate;
+   int  voltage;
+} supply_t;
+
+static supply_t *_supplies = NULL;
+static int       _supplies_count = 0;
+static bool      _supplies_found = false;
 
-   if (sysctlbyname
-         ("net.link.generic.system.ifcount", &count, &len, NULL, 0) < 0)
-     return;
+static int
+_supply_open(int dir_fd, const char *name)
+{
+   return openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+}
 
-   ifmd = malloc(sizeof(struct ifmibdata));
-   if (!ifmd)
-     return;
+static bool
+_supply_read(int fd, char *buf, size_t size)
+{
+   ssize_t bytes;
 
-   for (i = 1; i <= count; i++) {
-        int mib[] = { CTL_NET, PF_LINK, NETLINK_GENERIC, IFMIB_IFDATA, i, IFDATA_GENERAL };
-        len = sizeof(*ifmd);
-        if (sysctl(mib, 6, ifmd, &len, NULL, 0) < 0) continue;
-        if (!strcmp(ifmd->ifmd_name, "lo0"))
-          continue;
-        *in += ifmd->ifmd_data.ifi_ibytes;
-        *out += ifmd->ifmd_data.ifi_obytes;
+   if (fd < 0) return false;
+
+   bytes = pread(fd, buf, size - 1, 0);
+   if (bytes <= 0)
+     {
+        // Removed without a uevent, look again next time.
+        if (bytes < 0 && errno == ENODEV)
+          _supplies_found = false;
+        return false;
      }
-   free(ifmd);
+
+   buf[bytes] = '\0';
+   buf[strcspn(buf, "\n")] = '\0';
+
+   return true;
 }
 
-#endif
+static bool
+_supply_value(int fd, double *value)
+{
+   char buf[32];
+
+   if (!_supply_read(fd, buf, sizeof(buf)))
+     return false;
+
+   *value = atof(buf);
+
+   return true;
+}
 
-#if defined(__OpenBSD__)
 static void
-_openbsd_generic_network_status(unsigned long int *in,
-                                unsigned long int *out)
+_supplies_clear(void)
 {
-   struct ifaddrs *interfaces, *ifa;
+   supply_t *supply;
 
-   if (getifaddrs(&interfaces) < 0)
-     return;
+   for (int i = 0; i < _supplies_count; i++)
+     {
+        supply = &_supplies[i];
+        if (supply->online >= 0) close(supply->online);
+        if (supply->status >= 0) close(supply->status);
+        if (supply->capacity >= 0) close(supply->capacity);
+        if (supply->now >= 0) close(supply->now);
+        if (supply->full >= 0) close(supply->full);
+        if (supply->rate >= 0) close(supply->rate);
+        if (supply->voltage >= 0) close(supply->voltage);
+     }
 
-   int sock = socket(AF_INET, SOCK_STREAM, 0);
-   if (sock < 0)
-     return;
+   free(_supplies);
+   _supplies = NULL;
+   _supplies_count = 0;
+}
 
-   for (ifa = interfaces; ifa; ifa = ifa->ifa_next) {
+static int
+_supply_filter(const struct dirent *dh)
+{
+   return dh->d_name[0] != '.';
+}
+
+static void
+_supplies_find(void)
+{
+   struct dirent **names;
+   supply_t supply, *tmp;
+   char path[PATH_MAX], type[32], scope[32];
+   int i, n, dir_fd;
+
+   n = scandir("/sys/class/power_supply", &names, _supply_filter, _sysfs_name_cmp);
+   if (n < 0) return;
+
+   for (i = 0; i < n; i++)
+     {
+        snprintf(path, sizeof(path), "/sys/class/power_supply/%s", names[i]->d_name);
+        dir_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir_fd < 0) continue;
+
+        memset(&supply, 0, sizeof(supply));
+        snprintf(supply.name, sizeof(supply.name), "%s", names[i]->d_name);
+        supply.online = supply.status = supply.capacity = -1;
+        supply.now = supply.full = supply.rate = supply.voltage = -1;
+
+        // Batteries of mice and other peripherals don't power this host.
+        if (_sysfs_line_read(dir_fd, "scope", scope, sizeof(scope)) && !strcmp(scope, "Device"))
+          {
+             close(dir_fd);
+             continue;
+          }
+
+        // Without a type, go by the names ACPI uses: BAT0, BAT10... and
+        // AC, ACAD, ADP1...
+        if (_sysfs_line_read(dir_fd, "type", type, sizeof(type)))
+          supply.mains = strcmp(type, "Battery") && strcmp(type, "UPS");
+        else
+          supply.mains = strncmp(supply.name, "BAT", 3) != 0;
+
+        if (supply.mains)
+          supply.online = _supply_open(dir_fd, "online");
+        else
+          {
+             supply.status = _supply_open(dir_fd, "status");
+             supply.capacity = _supply_open(dir_fd, "capacity");
+             supply.now = _supply_open(dir_fd, "energy_now");
+             if (supply.now >= 0)
+               {
+                  supply.full = _supply_open(dir_fd, "energy_full");
+                  supply.rate = _supply_open(dir_fd, "power_now");
+               }
+             else
+               {
+                  supply.charge = true;
+                  supply.now = _supply_open(dir_fd, "charge_now");
+                  supply.full = _supply_open(dir_fd, "charge_full");
+                  supply.rate = _supply_open(dir_fd, "current_now");
+                  supply.voltage = _supply_open(dir_fd, "voltage_now");
+               }
+          }
+
+        close(dir_fd);
+
+        if (supply.online < 0 && supply.capacity < 0 && supply.now < 0)
+          continue;
+
+        tmp = realloc(_supplies, (_supplies_count + 1) * sizeof(supply_t));
+        if (!tmp) break;
+        _supplies = tmp;
+        _supplies[_supplies_count++] = supply;
+     }
+
+   for (i = 0; i < n; i++)
+     free(names[i]);
+   free(names);
+}
+
+static void
+_supplies_read(Sys_Power *power)
+{
+   supply_t *supply;
+   char status[32];
+   double value, now, full, rate, voltage, percent;
+   double sum_now = 0, sum_full = 0, sum_rate = 0, sum_drain = 0, sum_percent = 0;
+   bool energy, mixed = false;
+
+   if (_uevent_take(UEVENT_POWER) || !_supplies_found)
+     {
+        _supplies_clear();
+        _supplies_find();
+        _supplies_found = true;
+     }
+
+   for (int i = 0; i < _supplies_count; i++)
+     {
+        supply = &_supplies[i];
+
+        if (supply->mains)
+          {
+             if (_supply_value(supply->online, &value))
+               {
+                  power->valid = 1;
+                  if (value) power->ac_online = 1;
+               }
+             continue;
+          }
+
+        energy = false;
+        voltage = 0;
+        if (_supply_value(supply->now, &now) && _supply_value(supply->full, &full) && full > 0)
+          {
+             percent = now * 100.0 / full;
+             if (!supply->charge)
+               energy = true;
+             else if (_supply_value(supply->voltage, &voltage) && voltage > 0)
+               {
+                  now *= voltage / 1000000.0;
+                  full *= voltage / 1000000.0;
+                  energy = true;
+               }
+          }
+        else if (_supply_value(supply->capacity, &value))
+          percent = value;
+        else
+          continue;
+
+        power->valid = 1;
+        power->battery_count++;
+        sum_percent += percent;
+
+        // Without its energy a battery can't be weighed against the others.
+        if (!energy)
+          {
+             mixed = true;
+             continue;
+          }
+
+        sum_now += now;
+        sum_full += full;
+
+        if (!_supply_read(supply->status, status, sizeof(status)) || strcmp(status, "Discharging"))
+          continue;
+
+        if (!_supply_value(supply->rate, &rate) || !rate)
+          continue;
+
+        // Some drivers report a negative current while discharging.
+        if (rate < 0) rate = -rate;
+        if (supply->charge)
+          rate *= voltage / 1000000.0;
+
+        sum_rate += rate;
+        sum_drain += now;
+     }
+
+   // Batteries in the same unit are weighed by size, otherwise their
+   // percentages are averaged and the drain of some can't be known.
+   if (mixed)
+     {
+        power->percent = sum_percent / power->battery_count;
+        return;
+     }
+
+   if (sum_full > 0)
+     power->percent = sum_now * 100.0 / sum_full;
+
+   if (sum_rate > 0)
+     {
+        power->time_to_empty = sum_drain / sum_rate * 3600.0;
+        power->power = sum_rate / 1000000.0;
+     }
+}
+
+#endif
+
+
+#if defined(__MacOS__) || defined(__FreeBSD__) || defined(__DragonFly__)
+static void
+_freebsd_generic_network_status(unsigned long int *in,
+                                unsigned long int *out)
+{
+   struct ifmibdata *ifmd;
+   size_t len;
+   int i, count;
+   len = sizeof(count);
+
+   if (sysctlbyname
+         ("net.link.generic.system.ifcount", &count, &len, NULL, 0) < 0)
+     return;
+
+   ifmd = malloc(sizeof(struct ifmibdata));
+   if (!ifmd)
+     return;
+
+   for (i = 1; i <= count; i++) {
+        int mib[] = { CTL_NET, PF_LINK, NETLINK_GENERIC, IFMIB_IFDATA, i, IFDATA_GENERAL };
+        len = sizeof(*ifmd);
+        if (sysctl(mib, 6, ifmd, &len, NULL, 0) < 0) continue;
+        if (!strcmp(ifmd->ifmd_name, "lo0"))
+          continue;
+        *in += ifmd->ifmd_data.ifi_ibytes;
+        *out += ifmd->ifmd_data.ifi_obytes;
+     }
+   free(ifmd);
+}
+
+#endif
+
+#if defined(__OpenBSD__)
+static void
+_openbsd_generic_network_status(unsigned long int *in,
+                                unsigned long int *out)
+{
+   struct ifaddrs *interfaces, *ifa;
+
+   if (getifaddrs(&interfaces) < 0)
+     return;
+
+   int sock = socket(AF_INET, SOCK_STREAM, 0);
+   if (sock < 0)
+     return;
+
+   for (ifa = interfaces; ifa; ifa = ifa->ifa_next) {
         struct ifreq ifreq;
         struct if_data if_data;
 
@@ -1145,6 +1931,7 @@ _network_transfer_get(results_t *results)
    results->outgoing = last_out - first_out;
 }
 
+#if !defined(__linux__)
 static double
 _results_cpu(cpu_core_t **cores, int cpu_count)
 {
@@ -1157,6 +1944,8 @@ _results_cpu(cpu_core_t **cores, int cpu_count)
    return total;
 }
 
+#endif
+
 int
 system_cpu_memory_get(double *percent_cpu, long *memory_total, long *memory_used)
 {
@@ -1164,21 +1953,704 @@ system_cpu_memory_get(double *percent_cpu, long *memory_total, long *memory_used
 
    memset(&results, 0, sizeof(results));
 
+#if defined(__linux__)
+   results.cpu_count = _cpu_usage_get(percent_cpu);
+#else
    results.cores = _cpu_cores_state_get(&results.cpu_count);
 
-   _memory_usage_get(&results.memory);
-
    *percent_cpu = _results_cpu(results.cores, results.cpu_count);
-   *memory_total = results.memory.total;
-   *memory_used = results.memory.used;
+#endif
+
+   if (memory_total || memory_used)
+     {
+        _memory_usage_get(&results.memory);
+        if (memory_total) *memory_total = results.memory.total;
+        if (memory_used) *memory_used = results.memory.used;
+     }
 
+#if !defined(__linux__)
    for (int i = 0; i < results.cpu_count; i++)
      {
         free(results.cores[i]);
      }
 
    free(results.cores);
+#endif
 
    return results.cpu_count;
 }
 
+int
+system_memory_get(Sys_Memory *memory)
+{
+   _memory_usage_get(memory);
+
+   return memory->total != 0;
+}
+
+Sys_Sensor *
+system_sensors_get(int *count)
+{
+#if defined(__linux__)
+   return _sensors_read(count);
+#else
+   Sys_Sensor *sensors;
+   int temperature;
+
+   *count = 0;
+
+   _temperature_cpu_get(&temperature);
+   if (temperature == INVALID_TEMP)
+     return NULL;
+
+   sensors = calloc(1, sizeof(Sys_Sensor));
+   if (!sensors) return NULL;
+
+   snprintf(sensors->name, sizeof(sensors->name), "cpu");
+   sensors->temperature = temperature;
+   *count = 1;
+
+   return sensors;
+#endif
+}
+
+int
+system_power_get(Sys_Power *power)
+{
+   memset(power, 0, sizeof(Sys_Power));
+#if defined(__linux__)
+   _supplies_read(power);
+#else
+   power_t state;
+
+   memset(&state, 0, sizeof(state));
+   if (!_power_battery_count_get(&state))
+     return 0;
+
+   _power_state_get(&state);
+
+   power->valid = 1;
+   power->ac_online = state.have_ac;
+   power->battery_count = state.battery_count;
+   power->percent = state.percent;
+#endif
+   return power->valid;
+}
+
+Sys_Sched_Cpu *
+system_sched_get(int *ncpu)
+{
+   Sys_Sched_Cpu *cpus = NULL, *tmp;
+   int count = 0;
+#if defined(__linux__)
+   FILE *f;
+   char line[1024];
+   unsigned long long run_time, wait_time, timeslices;
+   int id;
+
+   f = fopen("/proc/schedstat", "r");
+   if (!f)
+     {
+        *ncpu = 0;
+        return NULL;
+     }
+
+   while (fgets(line, sizeof(line), f))
+     {
+        if (strncmp(line, "cpu", 3)) continue;
+
+        if (sscanf(line, "cpu%d %*u %*u %*u %*u %*u %*u %llu %llu %llu",
+                   &id, &run_time, &wait_time, &timeslices) != 4)
+          continue;
+
+        tmp = realloc(cpus, (count + 1) * sizeof(Sys_Sched_Cpu));
+        if (!tmp) break;
+        cpus = tmp;
+
+        cpus[count].id = id;
+        cpus[count].run_time = run_time;
+        cpus[count].wait_time = wait_time;
+        cpus[count].timeslices = timeslices;
+        count++;
+     }
+
+   fclose(f);
+#endif
+   *ncpu = count;
+
+   return cpus;
+}
+
+#if defined(__linux__)
+static const char *_pressure_paths[SYS_PRESSURE_RESOURCES] = {
+   "/proc/pressure/cpu", "/proc/pressure/memory", "/proc/pressure/io",
+};
+
+// A stall of 10% of a 2 second window. Unprivileged triggers need the
+// window to be a multiple of 2 seconds.
+# define PRESSURE_TRIGGER "some 200000 2000000"
+
+static int  _pressure_fds[SYS_PRESSURE_RESOURCES] = { -1, -1, -1 };
+static int  _pressure_triggers[SYS_PRESSURE_RESOURCES] = { -1, -1, -1 };
+static bool _pressure_triggers_checked = false;
+
+// "some avg10=0.00 avg60=0.00 avg300=0.00 total=0"
+static void
+_pressure_line_parse(const char *line, double *avg10, double *avg60, uint64_t *total)
+{
+   unsigned long long value;
+
+   if (sscanf(line, "%*s avg10=%lf avg60=%lf avg300=%*f total=%llu", avg10, avg60, &value) == 3)
+     *total = value;
+}
+
+#endif
+
+int
+system_pressure_get(Sys_Pressure pressure[SYS_PRESSURE_RESOURCES])
+{
+   int i, count = 0;
+#if defined(__linux__)
+   char buf[256], *line;
+   ssize_t bytes;
+#endif
+
+   for (i = 0; i < SYS_PRESSURE_RESOURCES; i++)
+     {
+        memset(&pressure[i], 0, sizeof(Sys_Pressure));
+#if defined(__linux__)
+        // Kernels without PSI, or with it disabled, are only tried once.
+        if (_pressure_fds[i] == -1)
+          {
+             _pressure_fds[i] = open(_pressure_paths[i], O_RDONLY | O_CLOEXEC);
+             if (_pressure_fds[i] < 0)
+               _pressure_fds[i] = -2;
+          }
+
+        if (_pressure_fds[i] < 0)
+          continue;
+
+        bytes = pread(_pressure_fds[i], buf, sizeof(buf) - 1, 0);
+        if (bytes <= 0)
+          continue;
+        buf[bytes] = '\0';
+
+        for (line = buf; line; line = strchr(line, '\n'), line = line ? line + 1 : NULL)
+          {
+             if (!strncmp(line, "some ", 5))
+               _pressure_line_parse(line, &pressure[i].some_avg10, &pressure[i].some_avg60, &pressure[i].some_total);
+             else if (!strncmp(line, "full ", 5))
+               _pressure_line_parse(line, &pressure[i].full_avg10, &pressure[i].full_avg60, &pressure[i].full_total);
+          }
+
+        pressure[i].valid = 1;
+        count++;
+#endif
+     }
+
+   return count;
+}
+
+int
+system_pressure_wait(int timeout)
+{
+#if defined(__linux__)
+   struct pollfd fds[SYS_PRESSURE_RESOURCES];
+   int i, n = 0, fired = 0;
+   int index[SYS_PRESSURE_RESOURCES];
+
+   if (!_pressure_triggers_checked)
+     {
+        _pressure_triggers_checked = true;
+
+        for (i = 0; i < SYS_PRESSURE_RESOURCES; i++)
+          {
+             _pressure_triggers[i] = open(_pressure_paths[i], O_RDWR | O_NONBLOCK | O_CLOEXEC);
+             if (_pressure_triggers[i] < 0)
+               continue;
+
+             if (write(_pressure_triggers[i], PRESSURE_TRIGGER, strlen(PRESSURE_TRIGGER) + 1) < 0)
+               {
+                  close(_pressure_triggers[i]);
+                  _pressure_triggers[i] = -1;
+               }
+          }
+     }
+
+   for (i = 0; i < SYS_PRESSURE_RESOURCES; i++)
+     {
+        if (_pressure_triggers[i] < 0)
+          continue;
+
+        fds[n].fd = _pressure_triggers[i];
+        fds[n].events = POLLPRI;
+        fds[n].revents = 0;
+        index[n++] = i;
+     }
+
+   if (!n)
+     {
+        usleep(timeout * 1000);
+        return 0;
+     }
+
+   if (poll(fds, n, timeout) <= 0)
+     return 0;
+
+   for (i = 0; i < n; i++)
+     {
+        if (fds[i].revents & POLLERR)
+          {
+             // The trigger went away, stop waiting on it.
+             close(fds[i].fd);
+             _pressure_triggers[index[i]] = -1;
+          }
+        else if (fds[i].revents & POLLPRI)
+          fired = 1;
+     }
+
+   return fired;
+#else
+   usleep(timeout * 1000);
+
+   return 0;
+#endif
+}
+
+#if defined(__linux__)
+// The counters of /proc/diskstats used, in its order after the name.
+enum
+{
+   DISK_READS,
+   DISK_READS_MERGED,
+   DISK_READ_SECTORS,
+   DISK_READ_TICKS,
+   DISK_WRITES,
+   DISK_WRITES_MERGED,
+   DISK_WRITE_SECTORS,
+   DISK_WRITE_TICKS,
+   DISK_IN_FLIGHT,
+   DISK_IO_TICKS,
+   DISK_QUEUE_TICKS,
+   DISK_COUNTERS,
+};
+
+typedef struct
+{
+   char               name[32];
+   unsigned int       flags;
+   unsigned long long counters[DISK_COUNTERS];
+} disk_state_t;
+
+static proc_file_t   _diskstats = { "/proc/diskstats", -1, NULL, 0 };
+static disk_state_t *_disks = NULL;
+static int           _disks_count = 0;
+static double        _disks_time = 0;
+
+static unsigned int
+_disk_flags(const char *name)
+{
+   char path[PATH_MAX], *p;
+   struct stat st;
+   unsigned int flags = 0;
+
+   // Only whole devices are listed under /sys/block, with '/' as '!'.
+   snprintf(path, sizeof(path), "/sys/block/%s", name);
+   for (p = path + 11; *p; p++)
+     {
+        if (*p == '/') *p = '!';
+     }
+
+   if (stat(path, &st) < 0)
+     return SYS_DISK_PARTITION;
+
+   if (strlen(path) + 8 > sizeof(path) || stat(strcat(path, "/device"), &st) < 0)
+     flags |= SYS_DISK_VIRTUAL;
+
+   return flags;
+}
+
+#endif
+
+Sys_Disk *
+system_disks_get(int *count, unsigned int exclude)
+{
+   Sys_Disk *disks = NULL;
+   int n = 0;
+#if defined(__linux__)
+   disk_state_t *states = NULL, *state, *prev, *tmp;
+   Sys_Disk *disk;
+   struct timespec ts;
+   unsigned long long d[DISK_COUNTERS];
+   char *line, *end, name[32];
+   double now, elapsed;
+   int i, j, k, nstates = 0, size = 0;
+
+   if (_proc_file_read(&_diskstats) < 0)
+     {
+        *count = 0;
+        return NULL;
+     }
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   now = ts.tv_sec + ts.tv_nsec / 1000000000.0;
+   elapsed = now - _disks_time;
+
+   // "   8       0 sda 1 2 3 4 5 6 7 8 9 10 11 ..."
+   for (line = _diskstats.buf, k = 0; line && *line; line = end ? end + 1 : NULL, k++)
+     {
+        end = strchr(line, '\n');
+
+        tmp = realloc(states, (nstates + 1) * sizeof(disk_state_t));
+        if (!tmp) break;
+        states = tmp;
+        state = &states[nstates];
+
+        if (sscanf(line, "%*u %*u %31s %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu", name,
+                   &state->counters[0], &state->counters[1], &state->counters[2], &state->counters[3],
+                   &state->counters[4], &state->counters[5], &state->counters[6], &state->counters[7],
+                   &state->counters[8], &state->counters[9], &state->counters[10]) != 1 + DISK_COUNTERS)
+          continue;
+
+        // Devices keep their order, so look where it was last time first.
+        prev = NULL;
+        for (j = 0; j < _disks_count && !prev; j++)
+          {
+             i = (k + j) % _disks_count;
+             if (!strcmp(_disks[i].name, name))
+               prev = &_disks[i];
+          }
+
+        snprintf(state->name, sizeof(state->name), "%s", name);
+        state->flags = prev ? prev->flags : _disk_flags(name);
+        nstates++;
+
+        if (state->flags & exclude)
+          continue;
+
+        if (n == size)
+          {
+             Sys_Disk *grown = realloc(disks, (size + 16) * sizeof(Sys_Disk));
+             if (!grown) break;
+             disks = grown;
+             size += 16;
+          }
+
+        disk = &disks[n++];
+        memset(disk, 0, sizeof(Sys_Disk));
+        snprintf(disk->name, sizeof(disk->name), "%s", name);
+        disk->flags = state->flags;
+
+        if (!prev || elapsed <= 0)
+          continue;
+
+        for (i = 0; i < DISK_COUNTERS; i++)
+          d[i] = state->counters[i] >= prev->counters[i] ? state->counters[i] - prev->counters[i] : 0;
+
+        disk->read_iops = d[DISK_READS] / elapsed;
+        disk->write_iops = d[DISK_WRITES] / elapsed;
+        // Sectors are always 512 bytes here, whatever the device's.
+        disk->read_bytes = d[DISK_READ_SECTORS] * 512.0 / elapsed;
+        disk->write_bytes = d[DISK_WRITE_SECTORS] * 512.0 / elapsed;
+        if (d[DISK_READS] + d[DISK_WRITES])
+          disk->await = (double) (d[DISK_READ_TICKS] + d[DISK_WRITE_TICKS]) / (d[DISK_READS] + d[DISK_WRITES]);
+        disk->queue = d[DISK_QUEUE_TICKS] / (elapsed * 1000);
+        disk->util = d[DISK_IO_TICKS] / (elapsed * 10);
+        if (disk->util > 100) disk->util = 100;
+     }
+
+   free(_disks);
+   _disks = states;
+   _disks_count = nstates;
+   _disks_time = now;
+
+   if (!n)
+     {
+        free(disks);
+        disks = NULL;
+     }
+#endif
+   *count = n;
+
+   return disks;
+}
+
+#if defined(__linux__)
+static proc_file_t  _vmstat = { "/proc/vmstat", -1, NULL, 0 };
+static proc_file_t  _loadavg = { "/proc/loadavg", -1, NULL, 0 };
+
+static unsigned long long _activity_prev[ACTIVITY_COUNTERS];
+static double             _activity_time = 0;
+static unsigned int       _activity_seen = 0;
+
+#endif
+
+int
+system_activity_get(Sys_Activity *activity)
+{
+   memset(activity, 0, sizeof(Sys_Activity));
+#if defined(__linux__)
+   unsigned long long counters[ACTIVITY_COUNTERS] = { 0 };
+   struct timespec ts;
+   double now, elapsed;
+   int i;
+
+   if (!_activity_slots_built)
+     _activity_slots_build();
+
+   if (_proc_file_read(&_loadavg) > 0)
+     sscanf(_loadavg.buf, "%lf %lf %lf", &activity->load[0], &activity->load[1], &activity->load[2]);
+
+   if (_stat_get(&_activity_seen))
+     memcpy(counters, _stat_counters, sizeof(counters));
+   if (_proc_file_read(&_vmstat) > 0)
+     _activity_parse(_vmstat.buf, counters);
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   now = ts.tv_sec + ts.tv_nsec / 1000000000.0;
+   elapsed = now - _activity_time;
+
+   activity->running = counters[ACTIVITY_RUNNING];
+   activity->blocked = counters[ACTIVITY_BLOCKED];
+
+# define RATE(counter) \
+   ((counters[counter] >= _activity_prev[counter]) ? (counters[counter] - _activity_prev[counter]) / elapsed : 0)
+
+   if (_activity_time && elapsed > 0)
+     {
+        activity->context_switches = RATE(ACTIVITY_CONTEXT_SWITCHES);
+        activity->forks = RATE(ACTIVITY_FORKS);
+        activity->swap_in = RATE(ACTIVITY_SWAP_IN);
+        activity->swap_out = RATE(ACTIVITY_SWAP_OUT);
+        activity->major_faults = RATE(ACTIVITY_MAJOR_FAULTS);
+        activity->pages_scanned = RATE(ACTIVITY_PAGES_SCANNED);
+     }
+
+# undef RATE
+
+   for (i = 0; i < ACTIVITY_COUNTERS; i++)
+     _activity_prev[i] = counters[i];
+   _activity_time = now;
+
+   activity->valid = 1;
+#endif
+
+   return activity->valid;
+}
+
+Sys_Cpu *
+system_cpu_times_get(int *ncpu)
+{
+   Sys_Cpu *cpus = NULL;
+   int count = 0;
+#if defined(__linux__)
+   static unsigned int seen = 0;
+
+   if (_stat_get(&seen) && _stat_cpus_count)
+     {
+        cpus = malloc(_stat_cpus_count * sizeof(Sys_Cpu));
+        if (cpus)
+          {
+             memcpy(cpus, _stat_cpus, _stat_cpus_count * sizeof(Sys_Cpu));
+             count = _stat_cpus_count;
+          }
+     }
+#endif
+   *ncpu = count;
+
+   return cpus;
+}
+
+#if defined(__linux__)
+typedef struct
+{
+   int         id;
+   char        path[PATH_MAX];
+   proc_file_t meminfo;
+   int         cpu_count;
+} node_t;
+
+static node_t *_nodes = NULL;
+static int     _nodes_count = 0;
+static bool    _nodes_found = false;
+// The node of each CPU, -1 for CPUs in no node.
+static int    *_cpu_nodes = NULL;
+static int     _cpu_nodes_count = 0;
+
+static int
+_node_filter(const struct dirent *dh)
+{
+   int id;
+
+   return sscanf(dh->d_name, "node%d", &id) == 1;
+}
+
+static void
+_nodes_clear(void)
+{
+   for (int i = 0; i < _nodes_count; i++)
+     {
+        if (_nodes[i].meminfo.fd >= 0)
+          close(_nodes[i].meminfo.fd);
+        free(_nodes[i].meminfo.buf);
+     }
+
+   free(_nodes);
+   _nodes = NULL;
+   _nodes_count = 0;
+
+   free(_cpu_nodes);
+   _cpu_nodes = NULL;
+   _cpu_nodes_count = 0;
+}
+
+// Mark the CPUs of a list such as "0-7,16-23" as being in a node.
+static int
+_node_cpulist_parse(const char *list, int node)
+{
+   const char *p = list;
+   char *end;
+   int *tmp, first, last, cpu, count = 0;
+
+   while (*p)
+     {
+        first = last = strtol(p, &end, 10);
+        if (end == p) break;
+        if (*end == '-')
+          {
+             p = end + 1;
+             last = strtol(p, &end, 10);
+             if (end == p) break;
+          }
+        p = *end == ',' ? end + 1 : end;
+
+        if (first < 0 || last < first || last >= 65536) break;
+
+        if (last >= _cpu_nodes_count)
+          {
+             tmp = realloc(_cpu_nodes, (last + 1) * sizeof(int));
+             if (!tmp) break;
+             _cpu_nodes = tmp;
+             for (cpu = _cpu_nodes_count; cpu <= last; cpu++)
+               _cpu_nodes[cpu] = -1;
+             _cpu_nodes_count = last + 1;
+          }
+
+        for (cpu = first; cpu <= last; cpu++)
+          _cpu_nodes[cpu] = node;
+        count += last - first + 1;
+     }
+
+   return count;
+}
+
+static void
+_nodes_find(void)
+{
+   struct dirent **names;
+   node_t *node;
+   char path[PATH_MAX], list[4096];
+   int i, n, dir_fd;
+
+   n = scandir("/sys/devices/system/node", &names, _node_filter, _sysfs_name_cmp);
+   if (n <= 0) return;
+
+   // Not grown after this, meminfo.path points into it.
+   _nodes = calloc(n, sizeof(node_t));
+   if (_nodes)
+     {
+        for (i = 0; i < n; i++)
+          {
+             node = &_nodes[_nodes_count];
+             sscanf(names[i]->d_name, "node%d", &node->id);
+             snprintf(node->path, sizeof(node->path), "/sys/devices/system/node/%s/meminfo", names[i]->d_name);
+             node->meminfo.path = node->path;
+             node->meminfo.fd = -1;
+
+             snprintf(path, sizeof(path), "/sys/devices/system/node/%s", names[i]->d_name);
+             dir_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+             if (dir_fd < 0) continue;
+
+             if (_sysfs_line_read(dir_fd, "cpulist", list, sizeof(list)))
+               node->cpu_count = _node_cpulist_parse(list, node->id);
+             close(dir_fd);
+
+             _nodes_count++;
+          }
+     }
+
+   for (i = 0; i < n; i++)
+     free(names[i]);
+   free(names);
+}
+
+#endif
+
+Sys_Node *
+system_nodes_get(int *count, const Sys_Cpu *cpus, int ncpu)
+{
+   Sys_Node *nodes = NULL;
+   int n = 0;
+#if defined(__linux__)
+   Sys_Node *node;
+   Sys_Memory *m;
+   unsigned long reclaimable;
+   int i, j, id;
+
+   if (_uevent_take(UEVENT_NODES) || !_nodes_found)
+     {
+        _nodes_clear();
+        _nodes_find();
+        _nodes_found = true;
+     }
+
+   if (_nodes_count)
+     nodes = calloc(_nodes_count, sizeof(Sys_Node));
+
+   for (i = 0; nodes && i < _nodes_count; i++)
+     {
+        if (_proc_file_read(&_nodes[i].meminfo) <= 0)
+          {
+             _nodes_found = false;
+             continue;
+          }
+
+        node = &nodes[n++];
+        node->id = _nodes[i].id;
+        node->cpu_count = _nodes[i].cpu_count;
+        node->cpu.id = node->id;
+
+        // Nodes have no MemAvailable: count page cache that isn't shared
+        // memory and reclaimable slab as available.
+        m = &node->memory;
+        _meminfo_parse(_nodes[i].meminfo.buf, m);
+        reclaimable = (m->cached > m->shared ? m->cached - m->shared : 0) + m->slab_reclaimable;
+        m->available = m->free + reclaimable;
+        if (m->available > m->total)
+          m->available = m->total;
+        m->used = m->total - m->available;
+        m->cached += m->slab_reclaimable;
+
+        for (j = 0; j < ncpu; j++)
+          {
+             id = cpus[j].id;
+             if (id < 0 || id >= _cpu_nodes_count || _cpu_nodes[id] != node->id)
+               continue;
+             for (int s = 0; s < SYS_CPU_STATES; s++)
+               node->cpu.ticks[s] += cpus[j].ticks[s];
+          }
+     }
+
+   if (!n)
+     {
+        free(nodes);
+        nodes = NULL;
+     }
+#else
+   (void) cpus;
+   (void) ncpu;
+#endif
+   *count = n;
+
+   return nodes;
+}
@@ -1,7 +1,237 @@
 #ifndef __SYSTEM_H__
 #define __SYSTEM_H__
 
+#include <stdint.h>
+
+// Memory usage in kilobytes. "used" is what the kernel can't hand out
+// without swapping, total less MemAvailable where the kernel reports it.
+// "cached" includes reclaimable slab.
+typedef struct _Sys_Memory
+{
+   unsigned long total;
+   unsigned long used;
+   unsigned long available;
+   unsigned long free;
+   unsigned long cached;
+   unsigned long buffered;
+   unsigned long shared;
+   unsigned long dirty;
+   unsigned long writeback;
+   unsigned long anon;
+   unsigned long slab;
+   unsigned long slab_reclaimable;
+   unsigned long swap_total;
+   unsigned long swap_free;
+   unsigned long swap_used;
+   // Huge pages in pages of huge_size kilobytes.
+   unsigned long huge_total;
+   unsigned long huge_free;
+   unsigned long huge_size;
+} Sys_Memory;
+
+// Cumulative scheduler counters of one CPU, in nanoseconds.
+typedef struct _Sys_Sched_Cpu
+{
+   int      id;
+   uint64_t run_time;
+   uint64_t wait_time;
+   uint64_t timeslices;
+} Sys_Sched_Cpu;
+
+// The states of /proc/stat, in its order. Guest time is already counted
+// in user and nice.
+typedef enum
+{
+   SYS_CPU_USER,
+   SYS_CPU_NICE,
+   SYS_CPU_SYSTEM,
+   SYS_CPU_IDLE,
+   SYS_CPU_IOWAIT,
+   SYS_CPU_IRQ,
+   SYS_CPU_SOFTIRQ,
+   SYS_CPU_STEAL,
+   SYS_CPU_STATES,
+} Sys_Cpu_State;
+
+// Cumulative time of one CPU in each state, in clock ticks.
+typedef struct _Sys_Cpu
+{
+   int      id;
+   uint64_t ticks[SYS_CPU_STATES];
+} Sys_Cpu;
+
+typedef enum
+{
+   SYS_PRESSURE_CPU,
+   SYS_PRESSURE_MEMORY,
+   SYS_PRESSURE_IO,
+   SYS_PRESSURE_RESOURCES,
+} Sys_Pressure_Resource;
+
+// Pressure stall information of one resource. "some" is when at least
+// one task stalled on it, "full" when all non-idle tasks did.
+typedef struct _Sys_Pressure
+{
+   int      valid;
+   // Percent of the last 10 and 60 seconds.
+   double   some_avg10;
+   double   some_avg60;
+   double   full_avg10;
+   double   full_avg60;
+   // Cumulative stall time in microseconds.
+   uint64_t some_total;
+   uint64_t full_total;
+} Sys_Pressure;
+
+typedef enum
+{
+   // A partition of another device.
+   SYS_DISK_PARTITION = (1 << 0),
+   // Not backed by hardware: loop, ram, zram, device mapper, md...
+   SYS_DISK_VIRTUAL   = (1 << 1),
+} Sys_Disk_Flags;
+
+// Block device activity since the previous system_disks_get().
+typedef struct _Sys_Disk
+{
+   char         name[32];
+   unsigned int flags;
+   // Completed requests and bytes per second.
+   double       read_iops;
+   double       write_iops;
+   double       read_bytes;
+   double       write_bytes;
+   // Average milliseconds per completed request, queued and serviced.
+   double       await;
+   // Average number of requests in flight.
+   double       queue;
+   // Percent of the time the device was busy.
+   double       util;
+} Sys_Disk;
+
+// A NUMA node. CPU ticks are those of its online CPUs added together,
+// memory is in kilobytes with "used" and "available" estimated as the
+// node has no MemAvailable.
+typedef struct _Sys_Node
+{
+   int        id;
+   int        cpu_count;
+   Sys_Cpu    cpu;
+   Sys_Memory memory;
+} Sys_Node;
+
+// Load and kernel activity. Rates are per second since the previous
+// system_activity_get().
+typedef struct _Sys_Activity
+{
+   int    valid;
+   // 1, 5 and 15 minute load averages.
+   double load[3];
+   // Tasks running or runnable, and blocked on I/O.
+   int    running;
+   int    blocked;
+   double context_switches;
+   double forks;
+   // Pages swapped in and out.
+   double swap_in;
+   double swap_out;
+   double major_faults;
+   // Pages scanned for reclaim, by kswapd and directly.
+   double pages_scanned;
+} Sys_Activity;
+
+// A temperature sensor.
+typedef struct _Sys_Sensor
+{
+   char   name[64];
+   // The CPU package it measures, -1 for other sensors.
+   int    socket;
+   // Degrees Celsius.
+   double temperature;
+} Sys_Sensor;
+
+// Power supplies, with batteries added together. Their charge is weighed
+// by energy when every battery reports it, otherwise averaged.
+typedef struct _Sys_Power
+{
+   int    valid;
+   int    ac_online;
+   int    battery_count;
+   // Charge left.
+   double percent;
+   // While discharging, seconds until empty and watts drawn. 0 when
+   // charging or unknown.
+   double time_to_empty;
+   double power;
+} Sys_Power;
+
+// Memory is skipped when both memory pointers are NULL. On Linux CPU use
+// is since the previous call, from the same read of /proc/stat as
+// system_cpu_times_get() and system_activity_get() make in that period,
+// elsewhere it is sampled over a second. Returns the online CPUs.
 int
 system_cpu_memory_get(double *percent_cpu, long *memory_total, long *memory_used);
 
+// Memory usage read from /proc/meminfo in one pass, or the closest
+// counters elsewhere. Fields the platform lacks are 0. Returns 0 on
+// failure.
+int
+system_memory_get(Sys_Memory *memory);
+
+// Every temperature sensor: thermal zones and hwmon temp*_input files on
+// Linux, found once and read through descriptors kept open. They are
+// looked for again when a uevent says a device came or went. Elsewhere
+// the one CPU sensor, named "cpu". Returns an array the caller must free,
+// or NULL when there are none.
+Sys_Sensor *
+system_sensors_get(int *count);
+
+// AC and battery state. On Linux supplies under /sys/class/power_supply
+// are found once, looked for again on a uevent, and each attribute is
+// read through a descriptor kept open. Returns 0 without any supply.
+int
+system_power_get(Sys_Power *power);
+
+// Per-CPU run queue counters from /proc/schedstat. Returns an array
+// the caller must free, or NULL where unsupported.
+Sys_Sched_Cpu *
+system_sched_get(int *ncpu);
+
+// Per-CPU time in each state from /proc/stat, read in one pass shared
+// with the other readers of the file. Offline CPUs are left out. Returns
+// an array the caller must free, or NULL where unsupported.
+Sys_Cpu *
+system_cpu_times_get(int *ncpu);
+
+// Pressure stall information from /proc/pressure, through descriptors
+// kept open between calls. Returns the number of resources read.
+int
+system_pressure_get(Sys_Pressure pressure[SYS_PRESSURE_RESOURCES]);
+
+// Sleep for up to timeout milliseconds. Where PSI triggers can be
+// registered, returns 1 as soon as one fires, meaning a resource is
+// stalling, otherwise 0.
+int
+system_pressure_wait(int timeout);
+
+// Per-device activity from /proc/diskstats since the previous call, the
+// first call only records counters and returns zero rates. Devices with
+// any of the exclude flags set are left out. Returns an array the caller
+// must free, or NULL where unsupported.
+Sys_Disk *
+system_disks_get(int *count, unsigned int exclude);
+
+// Load averages from /proc/loadavg and activity from /proc/stat and
+// /proc/vmstat, using the read of /proc/stat shared with the CPU readers.
+// The first call returns zero rates. Returns 0 where unsupported.
+int
+system_activity_get(Sys_Activity *activity);
+
+// NUMA nodes from /sys/devices/system/node, found once and looked for
+// again on a uevent. CPU times of the nodes are summed from cpus, as
+// returned by system_cpu_times_get(), so /proc/stat isn't read again.
+// Returns an array the caller must free, or NULL where unsupported.
+Sys_Node *
+system_nodes_get(int *count, const Sys_Cpu *cpus, int ncpu);
+
 #endif
@@ -1,9 +1,14 @@
 #include "system.h"
 #include "process.h"
 #include "ui.h"
+#include "users.h"
+#include "watch.h"
+#include "alert.h"
+#include "cgroup.h"
 #include <stdio.h>
+#include <ctype.h>
+#include <math.h>
 #include <sys/types.h>
-#include <pwd.h>
 
 #if defined(__APPLE__) && defined(__MACH__)
 # define __MacOS__
@@ -26,7 +31,17 @@ _system_stats(void *data, Ecore_Thread *thread)
    while (1)
      {
         sys = malloc(sizeof(Sys_Stats));
-        sys->cpu_count = system_cpu_memory_get(&sys->cpu_usage, &sys->mem_total, &sys->mem_used);
+        sys->cpu_count = system_cpu_memory_get(&sys->cpu_usage, NULL, NULL);
+        system_memory_get(&sys->memory);
+        sys->sched = system_sched_get(&sys->sched_count);
+        sys->cpu_times = system_cpu_times_get(&sys->cpu_times_count);
+        sys->nodes = system_nodes_get(&sys->nodes_count, sys->cpu_times, sys->cpu_times_count);
+        system_pressure_get(sys->pressure);
+        system_activity_get(&sys->activity);
+        sys->disks = system_disks_get(&sys->disks_count, ui->disks_all ? 0 : SYS_DISK_PARTITION | SYS_DISK_VIRTUAL);
+        sys->sensors = system_sensors_get(&sys->sensors_count);
+        system_power_get(&sys->power);
+        sys->time = ecore_time_get();
 
         ecore_thread_feedback(thread, sys);
 
@@ -35,11 +50,444 @@ _system_stats(void *data, Ecore_Thread *thread)
               if (ecore_thread_check(thread))
                 return;
 
-              usleep(500000);
+              // Sample straight away when something starts stalling.
+              if (system_pressure_wait(500))
+                break;
            }
      }
 }
 
+static void
+_sched_summary_update(Ui *ui, Sys_Stats *sys)
+{
+   double elapsed, delay, total = 0, worst = 0;
+   int i, worst_cpu = 0;
+
+   elapsed = sys->time - ui->sched_prev_time;
+
+   if (ui->sched_prev && ui->sched_prev_count == sys->sched_count && elapsed > 0)
+     {
+        for (i = 0; i < sys->sched_count; i++)
+          {
+             if (sys->sched[i].wait_time < ui->sched_prev[i].wait_time)
+               continue;
+
+             delay = (sys->sched[i].wait_time - ui->sched_prev[i].wait_time) / 1000000.0 / elapsed;
+             total += delay;
+             if (delay > worst)
+               {
+                  worst = delay;
+                  worst_cpu = sys->sched[i].id;
+               }
+          }
+
+        elm_object_text_set(ui->label_sched, eina_slstr_printf("avg %.1f ms/s, worst cpu%d %.1f ms/s",
+                            total / sys->sched_count, worst_cpu, worst));
+     }
+
+   free(ui->sched_prev);
+   ui->sched_prev = sys->sched;
+   ui->sched_prev_count = sys->sched_count;
+   ui->sched_prev_time = sys->time;
+   sys->sched = NULL;
+}
+
+static void
+_pressure_update(Ui *ui, Sys_Stats *sys)
+{
+   static const char *names[SYS_PRESSURE_RESOURCES] = { "cpu", "mem", "io" };
+   const Sys_Pressure *now, *prev;
+   char buf[512];
+   double elapsed, stalled;
+   int i;
+
+   buf[0] = '\0';
+   elapsed = sys->time - ui->pressure_prev_time;
+
+   for (i = 0; i < SYS_PRESSURE_RESOURCES; i++)
+     {
+        now = &sys->pressure[i];
+        prev = &ui->pressure_prev[i];
+        if (!now->valid) continue;
+
+        // Milliseconds per second some task stalled since the last sample.
+        stalled = 0;
+        if (prev->valid && elapsed > 0 && now->some_total >= prev->some_total)
+          stalled = (now->some_total - prev->some_total) / 1000.0 / elapsed;
+
+        eina_strlcat(buf, eina_slstr_printf("%s%s %.1f/%.1f%% %.0f ms/s", buf[0] ? ", " : "", names[i],
+                                            now->some_avg10, now->some_avg60, stalled), sizeof(buf));
+     }
+
+   elm_object_text_set(ui->label_pressure, buf[0] ? buf : "unavailable");
+
+   memcpy(ui->pressure_prev, sys->pressure, sizeof(ui->pressure_prev));
+   ui->pressure_prev_time = sys->time;
+}
+
+static void
+_memory_update(Ui *ui, Sys_Stats *sys)
+{
+   const Sys_Memory *m = &sys->memory;
+   char buf[1024];
+
+   _memory_total = m->total >> 10;
+   _memory_used = m->used >> 10;
+
+   elm_progressbar_value_set(ui->progress_mem, m->total ? (double) m->used / m->total : 0);
+   alert_system_set(ALERT_SYSTEM_MEMORY, m->total ? m->used * 100.0 / m->total : NAN);
+
+   if (!m->total)
+     {
+        elm_object_tooltip_text_set(ui->progress_mem, NULL);
+        return;
+     }
+
+   // Megabytes, with the breakdown the kernel gives.
+   snprintf(buf, sizeof(buf), "Available: %lu M<br>Free: %lu M<br>Cached: %lu M<br>Buffers: %lu M<br>"
+            "Shared: %lu M<br>Anonymous: %lu M<br>Slab: %lu M (%lu M reclaimable)<br>"
+            "Dirty: %lu M<br>Writeback: %lu M<br>Swap: %lu M out of %lu M",
+            m->available >> 10, m->free >> 10, m->cached >> 10, m->buffered >> 10, m->shared >> 10,
+            m->anon >> 10, m->slab >> 10, m->slab_reclaimable >> 10, m->dirty >> 10, m->writeback >> 10,
+            m->swap_used >> 10, m->swap_total >> 10);
+
+   if (m->huge_total)
+     eina_strlcat(buf, eina_slstr_printf("<br>Huge pages: %lu free of %lu, %lu K each",
+                                         m->huge_free, m->huge_total, m->huge_size), sizeof(buf));
+
+   elm_object_tooltip_text_set(ui->progress_mem, buf);
+}
+
+// Sockets beyond this share the last slot.
+#define SENSORS_SOCKETS_MAX 16
+
+static void
+_sensors_update(Ui *ui, Sys_Stats *sys)
+{
+   const Sys_Sensor *sensor, *hottest = NULL;
+   double sockets[SENSORS_SOCKETS_MAX], cpu = NAN;
+   char text[512], tip[4096];
+   int i, socket, nsockets = 0;
+
+   tip[0] = '\0';
+
+   for (i = 0; i < sys->sensors_count; i++)
+     {
+        sensor = &sys->sensors[i];
+        if (!hottest || sensor->temperature > hottest->temperature)
+          hottest = sensor;
+
+        eina_strlcat(tip, eina_slstr_printf("%s%s: %.1f °C", tip[0] ? "<br>" : "", sensor->name,
+                                            sensor->temperature), sizeof(tip));
+
+        if (sensor->socket < 0) continue;
+
+        socket = sensor->socket < SENSORS_SOCKETS_MAX ? sensor->socket : SENSORS_SOCKETS_MAX - 1;
+        for (; nsockets <= socket; nsockets++)
+          sockets[nsockets] = NAN;
+        if (isnan(sockets[socket]) || sensor->temperature > sockets[socket])
+          sockets[socket] = sensor->temperature;
+        if (isnan(cpu) || sensor->temperature > cpu)
+          cpu = sensor->temperature;
+     }
+
+   alert_system_set(ALERT_SYSTEM_TEMPERATURE, cpu);
+
+   if (!hottest)
+     {
+        elm_object_text_set(ui->label_sensors, "unavailable");
+        elm_object_tooltip_text_set(ui->label_sensors, NULL);
+        return;
+     }
+
+   // The hottest of each CPU package, then the hottest sensor anywhere.
+   text[0] = '\0';
+   for (i = 0; i < nsockets; i++)
+     {
+        if (isnan(sockets[i])) continue;
+        eina_strlcat(text, eina_slstr_printf("cpu%d %.0f °C, ", i, sockets[i]), sizeof(text));
+     }
+   eina_strlcat(text, eina_slstr_printf("hottest %s %.0f °C", hottest->name, hottest->temperature), sizeof(text));
+
+   elm_object_text_set(ui->label_sensors, text);
+   elm_object_tooltip_text_set(ui->label_sensors, tip);
+}
+
+static void
+_power_update(Ui *ui, Sys_Stats *sys)
+{
+   const Sys_Power *p = &sys->power;
+   int minutes;
+
+   if (!p->valid)
+     {
+        elm_object_text_set(ui->label_power, "unavailable");
+        return;
+     }
+
+   if (!p->battery_count)
+     {
+        elm_object_text_set(ui->label_power, p->ac_online ? "AC" : "AC offline");
+        return;
+     }
+
+   if (p->time_to_empty > 0)
+     {
+        minutes = p->time_to_empty / 60;
+        elm_object_text_set(ui->label_power, eina_slstr_printf("%.0f%%, %d:%02d left, %.1f W", p->percent,
+                            minutes / 60, minutes % 60, p->power));
+     }
+   else
+     elm_object_text_set(ui->label_power, eina_slstr_printf("%.0f%%%s", p->percent, p->ac_online ? ", on AC" : ""));
+
+   elm_object_tooltip_text_set(ui->label_power, eina_slstr_printf("%d batter%s", p->battery_count,
+                               p->battery_count == 1 ? "y" : "ies"));
+}
+
+static void
+_activity_update(Ui *ui, Sys_Stats *sys)
+{
+   const Sys_Activity *a = &sys->activity;
+
+   alert_system_set(ALERT_SYSTEM_LOAD, a->valid ? a->load[0] : NAN);
+   alert_system_set(ALERT_SYSTEM_FORKS, a->valid ? a->forks : NAN);
+
+   if (!a->valid)
+     {
+        elm_object_text_set(ui->label_activity, "unavailable");
+        return;
+     }
+
+   elm_object_text_set(ui->label_activity, eina_slstr_printf("%.2f %.2f %.2f, %d running, %d blocked, %.0f forks/s",
+                       a->load[0], a->load[1], a->load[2], a->running, a->blocked, a->forks));
+   elm_object_tooltip_text_set(ui->label_activity,
+                               eina_slstr_printf("Context switches: %.0f/s<br>Swap in: %.0f pages/s<br>"
+                                                 "Swap out: %.0f pages/s<br>Major faults: %.0f/s<br>"
+                                                 "Pages scanned: %.0f/s", a->context_switches, a->swap_in,
+                                                 a->swap_out, a->major_faults, a->pages_scanned));
+}
+
+static void
+_disks_update(Ui *ui, Sys_Stats *sys)
+{
+   const Sys_Disk *disk, *busiest = NULL;
+   char buf[4096];
+   int i;
+
+   buf[0] = '\0';
+
+   for (i = 0; i < sys->disks_count; i++)
+     {
+        disk = &sys->disks[i];
+        if (!busiest || disk->util > busiest->util)
+          busiest = disk;
+
+        eina_strlcat(buf, eina_slstr_printf("%s%s: %.0f%% util, read %.0f/s %.1f K/s, write %.0f/s %.1f K/s, "
+                                            "await %.2f ms, queue %.2f", buf[0] ? "<br>" : "", disk->name,
+                                            disk->util, disk->read_iops, disk->read_bytes / 1024.0,
+                                            disk->write_iops, disk->write_bytes / 1024.0,
+                                            disk->await, disk->queue), sizeof(buf));
+     }
+
+   if (!busiest)
+     {
+        elm_object_text_set(ui->label_disks, "unavailable");
+        elm_object_tooltip_text_set(ui->label_disks, NULL);
+        return;
+     }
+
+   // The busiest device here, all of them in the tooltip.
+   elm_object_text_set(ui->label_disks, eina_slstr_printf("%s %.0f%%, %.1f/%.1f M/s, %.2f ms", busiest->name,
+                       busiest->util, busiest->read_bytes / 1048576.0, busiest->write_bytes / 1048576.0,
+                       busiest->await));
+   elm_object_tooltip_text_set(ui->label_disks, buf);
+}
+
+// Hosts with at least this many cores get a heat map rather than a bar
+// per core, with this many cores to a line.
+#define CORES_HEATMAP_MIN   64
+#define CORES_HEATMAP_WIDTH 32
+#define CORES_BAR_WIDTH     20
+
+static const char *_cpu_state_names[SYS_CPU_STATES] = {
+   "us", "ni", "sy", "id", "wa", "hi", "si", "st",
+};
+
+static const char *_sparkline_glyphs[] = { "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█" };
+
+// Percent of the time in each state, returns the busy percentage.
+static double
+_cpu_states_percent(const Sys_Cpu *cpu, const Sys_Cpu *prev, double percent[SYS_CPU_STATES])
+{
+   uint64_t delta[SYS_CPU_STATES], total = 0;
+   int s;
+
+   for (s = 0; s < SYS_CPU_STATES; s++)
+     {
+        delta[s] = cpu->ticks[s] >= prev->ticks[s] ? cpu->ticks[s] - prev->ticks[s] : 0;
+        total += delta[s];
+     }
+
+   for (s = 0; s < SYS_CPU_STATES; s++)
+     percent[s] = total ? delta[s] * 100.0 / total : 0;
+
+   return 100 - percent[SYS_CPU_IDLE] - percent[SYS_CPU_IOWAIT];
+}
+
+static const char *
+_cpu_states_text(const double percent[SYS_CPU_STATES])
+{
+   char buf[256];
+   int s;
+
+   buf[0] = '\0';
+
+   for (s = 0; s < SYS_CPU_STATES; s++)
+     {
+        if (s == SYS_CPU_IDLE) continue;
+        eina_strlcat(buf, eina_slstr_printf(" %s %5.1f", _cpu_state_names[s], percent[s]), sizeof(buf));
+     }
+
+   return eina_slstr_printf("%s", buf);
+}
+
+static void
+_cores_update(Ui *ui, Sys_Stats *sys)
+{
+   Sys_Cpu all, all_prev;
+   double percent[SYS_CPU_STATES], busy;
+   double busiest = -1, steal = -1, iowait = -1;
+   int busiest_cpu = 0, steal_cpu = 0, iowait_cpu = 0;
+   int i, s, n, heatmap, level;
+   char *text;
+
+   if (!ui->show_cores || !ui->cpu_times_prev || ui->cpu_times_prev_count != sys->cpu_times_count)
+     goto out;
+
+   text = malloc(TEXT_FIELD_MAX);
+   if (!text) goto out;
+
+   memset(&all, 0, sizeof(all));
+   memset(&all_prev, 0, sizeof(all_prev));
+
+   for (i = 0; i < sys->cpu_times_count; i++)
+     {
+        for (s = 0; s < SYS_CPU_STATES; s++)
+          {
+             all.ticks[s] += sys->cpu_times[i].ticks[s];
+             all_prev.ticks[s] += ui->cpu_times_prev[i].ticks[s];
+          }
+     }
+
+   busy = _cpu_states_percent(&all, &all_prev, percent);
+   snprintf(text, TEXT_FIELD_MAX, "all   %5.1f%% %s<br>", busy, _cpu_states_text(percent));
+
+   heatmap = sys->cpu_times_count >= CORES_HEATMAP_MIN;
+
+   for (i = 0; i < sys->cpu_times_count; i++)
+     {
+        busy = _cpu_states_percent(&sys->cpu_times[i], &ui->cpu_times_prev[i], percent);
+
+        if (busy > busiest)
+          {
+             busiest = busy;
+             busiest_cpu = sys->cpu_times[i].id;
+          }
+        if (percent[SYS_CPU_STEAL] > steal)
+          {
+             steal = percent[SYS_CPU_STEAL];
+             steal_cpu = sys->cpu_times[i].id;
+          }
+        if (percent[SYS_CPU_IOWAIT] > iowait)
+          {
+             iowait = percent[SYS_CPU_IOWAIT];
+             iowait_cpu = sys->cpu_times[i].id;
+          }
+
+        if (heatmap)
+          {
+             level = busy / 100 * 7 + 0.5;
+             if (level < 0) level = 0;
+             if (level > 7) level = 7;
+             eina_strlcat(text, eina_slstr_printf("<color=%s>%s</color>",
+                                                  busy >= 90 ? "#ff4040" : busy >= 50 ? "#ffb040" : "#40c040",
+                                                  _sparkline_glyphs[level]), TEXT_FIELD_MAX);
+             if ((i + 1) % CORES_HEATMAP_WIDTH == 0 || i == sys->cpu_times_count - 1)
+               eina_strlcat(text, "<br>", TEXT_FIELD_MAX);
+             continue;
+          }
+
+        n = busy / 100 * CORES_BAR_WIDTH + 0.5;
+        eina_strlcat(text, eina_slstr_printf("cpu%-3d%5.1f%% ", sys->cpu_times[i].id, busy), TEXT_FIELD_MAX);
+        for (s = 0; s < CORES_BAR_WIDTH; s++)
+          eina_strlcat(text, s < n ? "█" : " ", TEXT_FIELD_MAX);
+        eina_strlcat(text, eina_slstr_printf("%s<br>", _cpu_states_text(percent)), TEXT_FIELD_MAX);
+     }
+
+   if (heatmap)
+     eina_strlcat(text, eina_slstr_printf("busiest cpu%d %.1f%%, most steal cpu%d %.1f%%, most iowait cpu%d %.1f%%",
+                                          busiest_cpu, busiest, steal_cpu, steal, iowait_cpu, iowait), TEXT_FIELD_MAX);
+
+   elm_object_text_set(ui->entry_cores, text);
+   free(text);
+
+out:
+   free(ui->cpu_times_prev);
+   ui->cpu_times_prev = sys->cpu_times;
+   ui->cpu_times_prev_count = sys->cpu_times_count;
+   sys->cpu_times = NULL;
+}
+
+// Each node's CPU use and memory, shown only with more than one node.
+static void
+_nodes_update(Ui *ui, Sys_Stats *sys)
+{
+   const Sys_Node *node, *prev;
+   const Sys_Memory *m;
+   double percent[SYS_CPU_STATES], busy;
+   char text[4096];
+   int i;
+
+   if (sys->nodes_count < 2)
+     {
+        evas_object_hide(ui->frame_nodes);
+        goto out;
+     }
+
+   text[0] = '\0';
+
+   for (i = 0; i < sys->nodes_count; i++)
+     {
+        node = &sys->nodes[i];
+        m = &node->memory;
+
+        prev = NULL;
+        if (ui->nodes_prev_count == sys->nodes_count && ui->nodes_prev[i].id == node->id)
+          prev = &ui->nodes_prev[i];
+
+        eina_strlcat(text, eina_slstr_printf("%snode%d: ", i ? "<br>" : "", node->id), sizeof(text));
+        if (prev && node->cpu_count)
+          {
+             busy = _cpu_states_percent(&node->cpu, &prev->cpu, percent);
+             eina_strlcat(text, eina_slstr_printf("%d cpus %.1f%%, ", node->cpu_count, busy), sizeof(text));
+          }
+        else if (!node->cpu_count)
+          eina_strlcat(text, "no cpus, ", sizeof(text));
+
+        eina_strlcat(text, eina_slstr_printf("%lu M used, %lu M free of %lu M", m->used >> 10, m->free >> 10,
+                                             m->total >> 10), sizeof(text));
+     }
+
+   elm_object_text_set(ui->label_nodes, text);
+   evas_object_show(ui->frame_nodes);
+
+out:
+   free(ui->nodes_prev);
+   ui->nodes_prev = sys->nodes;
+   ui->nodes_prev_count = sys->nodes_count;
+   sys->nodes = NULL;
+}
+
 static void
 _system_stats_feedback_cb(void *data, Ecore_Thread *thread, void *msg)
 {
@@ -52,13 +500,29 @@ _system_stats_feedback_cb(void *data, Ecore_Thread *thread, void *msg)
     if (ecore_thread_check(thread))
       goto out;
 
-   _memory_total = sys->mem_total >>= 10;
-   _memory_used = sys->mem_used >>= 10;
+   if (sys->cpu_count > 0)
+     ui->cpu_count = sys->cpu_count;
 
    elm_progressbar_value_set(ui->progress_cpu, (double)sys->cpu_usage / 100);
-   elm_progressbar_value_set(ui->progress_mem, (double)((sys->mem_total / 100.0) * sys->mem_used) / 1000000);
+
+   _memory_update(ui, sys);
+   _sched_summary_update(ui, sys);
+   _nodes_update(ui, sys);
+   _cores_update(ui, sys);
+   _pressure_update(ui, sys);
+   _disks_update(ui, sys);
+   _activity_update(ui, sys);
+   _sensors_update(ui, sys);
+   _power_update(ui, sys);
+
+   alert_system_set(ALERT_SYSTEM_CPU, sys->cpu_usage);
 
 out:
+   free(sys->sched);
+   free(sys->cpu_times);
+   free(sys->disks);
+   free(sys->sensors);
+   free(sys->nodes);
    free(sys);
 }
 
@@ -82,6 +546,24 @@ _sort_by_uid(const void *p1, const void *p2)
    return inf1->uid - inf2->uid;
 }
 
+static int
+_sort_by_user(const void *p1, const void *p2)
+{
+   const Proc_Stats *inf1, *inf2;
+
+   inf1 = p1; inf2 = p2;
+
+   // Names still being resolved sort ahead of everything else.
+   if (!inf1->user && !inf2->user)
+     return inf1->uid - inf2->uid;
+   if (!inf1->user)
+     return -1;
+   if (!inf2->user)
+     return 1;
+
+   return strcmp(inf1->user, inf2->user);
+}
+
 static int
 _sort_by_nice(const void *p1, const void *p2)
 {
@@ -180,69 +662,394 @@ _sort_by_cpu_usage(const void *p1, const void *p2)
 }
 
 static int
-_sort_by_cmd(const void *p1, const void *p2)
+_sort_by_io_read(const void *p1, const void *p2)
 {
    const Proc_Stats *inf1, *inf2;
+   double one, two;
 
    inf1 = p1; inf2 = p2;
 
-   return strcasecmp(inf1->command, inf2->command);
+   one = inf1->io_read_rate;
+   two = inf2->io_read_rate;
+
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
+
+   return 0;
 }
 
 static int
-_sort_by_state(const void *p1, const void *p2)
+_sort_by_io_write(const void *p1, const void *p2)
 {
    const Proc_Stats *inf1, *inf2;
+   double one, two;
 
    inf1 = p1; inf2 = p2;
 
-   return strcmp(inf1->state, inf2->state);
-}
+   one = inf1->io_write_rate;
+   two = inf2->io_write_rate;
 
-static void
-_fields_append(Ui *ui, Proc_Stats *proc)
-{
-   // FIXME: hiding self from the list until more efficient.
-   // It's not too bad but it pollutes a lovely list.
-   if (ui->program_pid == proc->pid)
-     return;
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
 
-   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_PID], eina_slstr_printf("<link>%d</link> <br>", proc->pid), TEXT_FIELD_MAX);
-   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_UID], eina_slstr_printf("%d <br>", proc->uid), TEXT_FIELD_MAX);
-   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_SIZE], eina_slstr_printf("%lld K<br>", proc->mem_size >> 10), TEXT_FIELD_MAX);
-   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_RSS], eina_slstr_printf("%lld K<br>", proc->mem_rss >> 10), TEXT_FIELD_MAX);
-   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_COMMAND], eina_slstr_printf("%s<br>", proc->command), TEXT_FIELD_MAX);
-   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_STATE], eina_slstr_printf("%s <br>", proc->state), TEXT_FIELD_MAX);
-   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_CPU_USAGE], eina_slstr_printf("%.1f%% <br>", proc->cpu_usage), TEXT_FIELD_MAX);
+   return 0;
 }
 
-static void
-_fields_show(Ui *ui)
+static int
+_sort_by_pss(const void *p1, const void *p2)
 {
-   elm_object_text_set(ui->entry_pid, ui->fields[PROCESS_INFO_FIELD_PID]);
-   elm_object_text_set(ui->entry_uid, ui->fields[PROCESS_INFO_FIELD_UID]);
-   elm_object_text_set(ui->entry_size, ui->fields[PROCESS_INFO_FIELD_SIZE]);
-   elm_object_text_set(ui->entry_rss, ui->fields[PROCESS_INFO_FIELD_RSS]);
-   elm_object_text_set(ui->entry_cmd, ui->fields[PROCESS_INFO_FIELD_COMMAND]);
-   elm_object_text_set(ui->entry_state, ui->fields[PROCESS_INFO_FIELD_STATE]);
-   elm_object_text_set(ui->entry_cpu_usage, ui->fields[PROCESS_INFO_FIELD_CPU_USAGE]);
+   const Proc_Stats *inf1, *inf2;
+   int64_t one, two;
+
+   inf1 = p1; inf2 = p2;
+
+   one = inf1->mem_pss;
+   two = inf2->mem_pss;
+
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
+
+   return 0;
 }
 
-static void
-_fields_clear(Ui *ui)
+static int
+_sort_by_uss(const void *p1, const void *p2)
 {
-   for (int i = 0; i < PROCESS_INFO_FIELDS; i++)
-     {
-        ui->fields[i][0] = '\0';
-     }
+   const Proc_Stats *inf1, *inf2;
+   int64_t one, two;
+
+   inf1 = p1; inf2 = p2;
+
+   one = inf1->mem_uss;
+   two = inf2->mem_uss;
+
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
+
+   return 0;
 }
 
-static void
-_fields_free(Ui *ui)
+static int
+_sort_by_swap(const void *p1, const void *p2)
 {
-   for (int i = 0; i < PROCESS_INFO_FIELDS; i++)
-     {
-        free(ui->fields[i]);
+   const Proc_Stats *inf1, *inf2;
+   int64_t one, two;
+
+   inf1 = p1; inf2 = p2;
+
+   one = inf1->mem_swap;
+   two = inf2->mem_swap;
+
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
+
+   return 0;
+}
+
+static int
+_sort_by_anon_huge(const void *p1, const void *p2)
+{
+   const Proc_Stats *inf1, *inf2;
+   int64_t one, two;
+
+   inf1 = p1; inf2 = p2;
+
+   one = inf1->mem_anon_huge;
+   two = inf2->mem_anon_huge;
+
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
+
+   return 0;
+}
+
+static int
+_sort_by_sched_delay(const void *p1, const void *p2)
+{
+   const Proc_Stats *inf1, *inf2;
+   double one, two;
+
+   inf1 = p1; inf2 = p2;
+
+   one = inf1->sched_delay;
+   two = inf2->sched_delay;
+
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
+
+   return 0;
+}
+
+static int
+_sort_by_minflt(const void *p1, const void *p2)
+{
+   const Proc_Stats *inf1, *inf2;
+   double one, two;
+
+   inf1 = p1; inf2 = p2;
+
+   one = inf1->minflt_rate;
+   two = inf2->minflt_rate;
+
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
+
+   return 0;
+}
+
+static int
+_sort_by_majflt(const void *p1, const void *p2)
+{
+   const Proc_Stats *inf1, *inf2;
+   double one, two;
+
+   inf1 = p1; inf2 = p2;
+
+   one = inf1->majflt_rate;
+   two = inf2->majflt_rate;
+
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
+
+   return 0;
+}
+
+static int
+_sort_by_rss_growth(const void *p1, const void *p2)
+{
+   const Proc_Stats *inf1, *inf2;
+   double one, two;
+
+   inf1 = p1; inf2 = p2;
+
+   one = inf1->mem_growth;
+   two = inf2->mem_growth;
+
+   if (one < two)
+     return -1;
+   if (one > two)
+     return 1;
+
+   return 0;
+}
+
+static int
+_sort_by_cmd(const void *p1, const void *p2)
+{
+   const Proc_Stats *inf1, *inf2;
+
+   inf1 = p1; inf2 = p2;
+
+   return strcasecmp(inf1->command, inf2->command);
+}
+
+static int
+_sort_by_state(const void *p1, const void *p2)
+{
+   const Proc_Stats *inf1, *inf2;
+
+   inf1 = p1; inf2 = p2;
+
+   return strcmp(inf1->state, inf2->state);
+}
+
+#define SPARKLINE_WIDTH 50
+
+static const char *
+_sparkline(const double *values, int n, double min, double max)
+{
+   char buf[SPARKLINE_WIDTH * 4 + 1];
+   int i, level;
+
+   buf[0] = '\0';
+
+   for (i = 0; i < n; i++)
+     {
+        level = 0;
+        if (max > min)
+          level = (values[i] - min) / (max - min) * 7 + 0.5;
+        if (level < 0) level = 0;
+        if (level > 7) level = 7;
+
+        eina_strlcat(buf, _sparkline_glyphs[level], sizeof(buf));
+     }
+
+   return eina_slstr_printf("%s", buf);
+}
+
+// Sparkline of CPU % over the last few polls.
+#define HISTORY_COLUMN_WIDTH 12
+
+static void
+_field_history_append(Ui *ui, Proc_Stats *proc)
+{
+   History_Point points[HISTORY_COLUMN_WIDTH];
+   double cpu[HISTORY_COLUMN_WIDTH], cpu_max = 1.0;
+   int i, n;
+
+   n = history_get(proc->pid, proc->start_time, HISTORY_TIER_FINE, HISTORY_CPU, points, HISTORY_COLUMN_WIDTH);
+   for (i = 0; i < n; i++)
+     {
+        cpu[i] = points[i].avg;
+        if (cpu[i] > cpu_max) cpu_max = cpu[i];
+     }
+
+   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_HISTORY], eina_slstr_printf("%s <br>", _sparkline(cpu, n, 0, cpu_max)), TEXT_FIELD_MAX);
+}
+
+// Resident memory growing faster than this, in bytes per hour, is
+// highlighted as a likely leak.
+#define RSS_GROWTH_HIGHLIGHT (64LL * 1024 * 1024)
+
+static void
+_field_rss_growth_append(Ui *ui, Proc_Stats *proc)
+{
+   const char *text;
+
+   if (!proc->mem_growth_valid)
+     text = "- <br>";
+   else if (proc->mem_growth > RSS_GROWTH_HIGHLIGHT)
+     text = eina_slstr_printf("<color=#ff4040>%+lld K/h</color><br>", (long long) proc->mem_growth >> 10);
+   else
+     text = eina_slstr_printf("%+lld K/h<br>", (long long) proc->mem_growth >> 10);
+
+   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_RSS_GROWTH], text, TEXT_FIELD_MAX);
+}
+
+static void
+_field_memory_append(Ui *ui, Proc_Stats_Field field, Proc_Stats *proc, int64_t value)
+{
+   if (proc->mem_detail)
+     eina_strlcat(ui->fields[field], eina_slstr_printf("%lld K<br>", (long long) value >> 10), TEXT_FIELD_MAX);
+   else
+     eina_strlcat(ui->fields[field], "- <br>", TEXT_FIELD_MAX);
+}
+
+static Eina_Bool
+_fields_append(Ui *ui, Proc_Stats *proc)
+{
+   // FIXME: hiding self from the list until more efficient.
+   // It's not too bad but it pollutes a lovely list.
+   if (ui->program_pid == proc->pid)
+     return EINA_FALSE;
+
+   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_PID], eina_slstr_printf("<link>%d</link> <br>", proc->pid), TEXT_FIELD_MAX);
+   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_UID], eina_slstr_printf("%d <br>", proc->uid), TEXT_FIELD_MAX);
+   if (proc->user)
+     eina_strlcat(ui->fields[PROCESS_INFO_FIELD_USER], eina_slstr_printf("%s <br>", proc->user), TEXT_FIELD_MAX);
+   else
+     eina_strlcat(ui->fields[PROCESS_INFO_FIELD_USER], eina_slstr_printf("%d <br>", proc->uid), TEXT_FIELD_MAX);
+   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_SIZE], eina_slstr_printf("%lld K<br>", proc->mem_size >> 10), TEXT_FIELD_MAX);
+   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_RSS], eina_slstr_printf("%lld K<br>", proc->mem_rss >> 10), TEXT_FIELD_MAX);
+   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_COMMAND], eina_slstr_printf("%s<br>", proc->command), TEXT_FIELD_MAX);
+   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_STATE], eina_slstr_printf("%s <br>", proc->state), TEXT_FIELD_MAX);
+   eina_strlcat(ui->fields[PROCESS_INFO_FIELD_CPU_USAGE], eina_slstr_printf("%.1f%% <br>", proc->cpu_usage), TEXT_FIELD_MAX);
+
+   if (ui->show_io)
+     {
+        eina_strlcat(ui->fields[PROCESS_INFO_FIELD_IO_READ], eina_slstr_printf("%.1f K/s<br>", proc->io_read_rate / 1024.0), TEXT_FIELD_MAX);
+        eina_strlcat(ui->fields[PROCESS_INFO_FIELD_IO_WRITE], eina_slstr_printf("%.1f K/s<br>", proc->io_write_rate / 1024.0), TEXT_FIELD_MAX);
+     }
+
+   if (ui->show_memory)
+     {
+        _field_memory_append(ui, PROCESS_INFO_FIELD_PSS, proc, proc->mem_pss);
+        _field_memory_append(ui, PROCESS_INFO_FIELD_USS, proc, proc->mem_uss);
+        _field_memory_append(ui, PROCESS_INFO_FIELD_SWAP, proc, proc->mem_swap);
+        _field_memory_append(ui, PROCESS_INFO_FIELD_ANON_HUGE, proc, proc->mem_anon_huge);
+     }
+
+   if (ui->show_sched)
+     eina_strlcat(ui->fields[PROCESS_INFO_FIELD_SCHED_DELAY], eina_slstr_printf("%.2f ms/s<br>", proc->sched_delay), TEXT_FIELD_MAX);
+
+   if (ui->show_faults)
+     {
+        eina_strlcat(ui->fields[PROCESS_INFO_FIELD_MINFLT], eina_slstr_printf("%.1f<br>", proc->minflt_rate), TEXT_FIELD_MAX);
+        eina_strlcat(ui->fields[PROCESS_INFO_FIELD_MAJFLT], eina_slstr_printf("%.1f<br>", proc->majflt_rate), TEXT_FIELD_MAX);
+     }
+
+   if (ui->show_history)
+     _field_history_append(ui, proc);
+
+   if (ui->show_rss_growth)
+     _field_rss_growth_append(ui, proc);
+
+   return EINA_TRUE;
+}
+
+static void
+_rows_append(Ui *ui, Proc_Stats *proc)
+{
+   Proc_Stats **rows;
+
+   if (ui->rows_count == ui->rows_size)
+     {
+        rows = realloc(ui->rows, (ui->rows_size + 256) * sizeof(Proc_Stats *));
+        if (!rows) return;
+        ui->rows = rows;
+        ui->rows_size += 256;
+     }
+
+   ui->rows[ui->rows_count++] = proc;
+}
+
+static void
+_fields_show(Ui *ui)
+{
+   elm_object_text_set(ui->entry_pid, ui->fields[PROCESS_INFO_FIELD_PID]);
+   elm_object_text_set(ui->entry_uid, ui->fields[PROCESS_INFO_FIELD_UID]);
+   elm_object_text_set(ui->entry_user, ui->fields[PROCESS_INFO_FIELD_USER]);
+   elm_object_text_set(ui->entry_size, ui->fields[PROCESS_INFO_FIELD_SIZE]);
+   elm_object_text_set(ui->entry_rss, ui->fields[PROCESS_INFO_FIELD_RSS]);
+   elm_object_text_set(ui->entry_cmd, ui->fields[PROCESS_INFO_FIELD_COMMAND]);
+   elm_object_text_set(ui->entry_state, ui->fields[PROCESS_INFO_FIELD_STATE]);
+   elm_object_text_set(ui->entry_cpu_usage, ui->fields[PROCESS_INFO_FIELD_CPU_USAGE]);
+   elm_object_text_set(ui->column_io_read.entry, ui->fields[PROCESS_INFO_FIELD_IO_READ]);
+   elm_object_text_set(ui->column_io_write.entry, ui->fields[PROCESS_INFO_FIELD_IO_WRITE]);
+   elm_object_text_set(ui->column_pss.entry, ui->fields[PROCESS_INFO_FIELD_PSS]);
+   elm_object_text_set(ui->column_uss.entry, ui->fields[PROCESS_INFO_FIELD_USS]);
+   elm_object_text_set(ui->column_swap.entry, ui->fields[PROCESS_INFO_FIELD_SWAP]);
+   elm_object_text_set(ui->column_anon_huge.entry, ui->fields[PROCESS_INFO_FIELD_ANON_HUGE]);
+   elm_object_text_set(ui->column_sched_delay.entry, ui->fields[PROCESS_INFO_FIELD_SCHED_DELAY]);
+   elm_object_text_set(ui->column_minflt.entry, ui->fields[PROCESS_INFO_FIELD_MINFLT]);
+   elm_object_text_set(ui->column_majflt.entry, ui->fields[PROCESS_INFO_FIELD_MAJFLT]);
+   elm_object_text_set(ui->column_history.entry, ui->fields[PROCESS_INFO_FIELD_HISTORY]);
+   elm_object_text_set(ui->column_rss_growth.entry, ui->fields[PROCESS_INFO_FIELD_RSS_GROWTH]);
+}
+
+static void
+_fields_clear(Ui *ui)
+{
+   for (int i = 0; i < PROCESS_INFO_FIELDS; i++)
+     {
+        ui->fields[i][0] = '\0';
+     }
+}
+
+static void
+_fields_free(Ui *ui)
+{
+   for (int i = 0; i < PROCESS_INFO_FIELDS; i++)
+     {
+        free(ui->fields[i]);
      }
 }
 
@@ -260,6 +1067,10 @@ _list_sort(Ui *ui, Eina_List *list)
         list = eina_list_sort(list, eina_list_count(list), _sort_by_uid);
         break;
 
+      case SORT_BY_USER:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_user);
+        break;
+
       case SORT_BY_NICE:
         list = eina_list_sort(list, eina_list_count(list), _sort_by_nice);
         break;
@@ -295,6 +1106,46 @@ _list_sort(Ui *ui, Eina_List *list)
       case SORT_BY_CPU_USAGE:
         list = eina_list_sort(list, eina_list_count(list), _sort_by_cpu_usage);
         break;
+
+      case SORT_BY_IO_READ:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_io_read);
+        break;
+
+      case SORT_BY_IO_WRITE:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_io_write);
+        break;
+
+      case SORT_BY_PSS:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_pss);
+        break;
+
+      case SORT_BY_USS:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_uss);
+        break;
+
+      case SORT_BY_SWAP:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_swap);
+        break;
+
+      case SORT_BY_ANON_HUGE:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_anon_huge);
+        break;
+
+      case SORT_BY_SCHED_DELAY:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_sched_delay);
+        break;
+
+      case SORT_BY_MINFLT:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_minflt);
+        break;
+
+      case SORT_BY_MAJFLT:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_majflt);
+        break;
+
+      case SORT_BY_RSS_GROWTH:
+        list = eina_list_sort(list, eina_list_count(list), _sort_by_rss_growth);
+        break;
      }
 
    if (ui->sort_reverse)
@@ -304,299 +1155,1987 @@ _list_sort(Ui *ui, Eina_List *list)
 }
 
 static void
-_system_process_list_feedback_cb(void *data, Ecore_Thread *thread EINA_UNUSED, void *msg EINA_UNUSED)
+_snapshot_free(Ui *ui)
 {
-   Ui *ui;
-   Eina_List *list, *l;
    Proc_Stats *proc;
 
-   eina_lock_take(&_lock);
+   EINA_LIST_FREE (ui->snapshot, proc)
+     free(proc);
+}
 
-   ui = data;
+static void
+_snapshot_set(Ui *ui, Eina_List *list)
+{
+   Eina_List *l;
+   Proc_Stats *proc;
+   size_t size = 0;
+   char *p;
 
-   list = proc_info_all_get();
+   _snapshot_free(ui);
+
+   ui->snapshot = list;
 
+   // Lower case copies of each command, in list order, for searching.
    EINA_LIST_FOREACH (list, l, proc)
+     size += strlen(proc->command) + 1;
+
+   if (size > ui->snapshot_commands_size)
      {
-        int64_t time_prev = ui->cpu_times[proc->pid];
-        proc->cpu_usage = 0;
-        if (!ui->first_run && proc->cpu_time > time_prev)
+        p = realloc(ui->snapshot_commands, size);
+        if (!p)
           {
-             proc->cpu_usage = (double) (proc->cpu_time - time_prev) / ui->poll_delay;
+             _snapshot_free(ui);
+             return;
           }
+        ui->snapshot_commands = p;
+        ui->snapshot_commands_size = size;
      }
 
-   list = _list_sort(ui, list);
-
-   EINA_LIST_FREE (list, proc)
+   p = ui->snapshot_commands;
+   EINA_LIST_FOREACH (list, l, proc)
      {
-        _fields_append(ui, proc);
-        ui->first_run = EINA_FALSE;
-        ui->cpu_times[proc->pid] = proc->cpu_time;
-
-        free(proc);
+        for (const char *c = proc->command; *c; c++)
+          *p++ = tolower((unsigned char) *c);
+        *p++ = '\0';
      }
+}
 
-   if (list)
-     eina_list_free(list);
+typedef struct _Tree_Node
+{
+   Proc_Stats *proc;
+   const char *command_lower;
+   int         parent;
+   int         first_child;
+   int         next_sibling;
+   int         depth;
+   int         size;
+   Eina_Bool   root;
+   double      cpu_usage;
+   int64_t     mem_rss;
+   int32_t     numthreads;
+} Tree_Node;
 
-   _fields_show(ui);
-   _fields_clear(ui);
+static Eina_Bool
+_tree_collapsed_stale_cb(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data EINA_UNUSED, void *fdata)
+{
+   void **args = fdata;
+   Eina_Hash *pids = args[0];
+   Eina_List **stale = args[1];
 
-   eina_lock_release(&_lock);
+   if (!eina_hash_find(pids, key))
+     *stale = eina_list_append(*stale, key);
+
+   return EINA_TRUE;
 }
 
 static void
-_system_process_list_update(Ui *ui)
+_tree_collapsed_prune(Ui *ui, Eina_Hash *pids)
 {
-   _system_process_list_feedback_cb(ui, NULL, NULL);
+   Eina_List *stale = NULL;
+   void *args[2] = { pids, &stale };
+   const void *key;
+
+   eina_hash_foreach(ui->tree_collapsed, _tree_collapsed_stale_cb, args);
+
+   EINA_LIST_FREE (stale, key)
+     eina_hash_del_by_key(ui->tree_collapsed, key);
+}
+
+static void
+_tree_row_append(Ui *ui, Tree_Node *node)
+{
+   Proc_Stats row;
+   const char *marker = "";
+
+   row = *node->proc;
+   row.cpu_usage = node->cpu_usage;
+   row.mem_rss = node->mem_rss;
+   row.numthreads = node->numthreads;
+
+   if (node->first_child != -1)
+     {
+        if (eina_hash_find(ui->tree_collapsed, &row.pid))
+          marker = eina_slstr_printf("<a href=%d>[+]</a> ", row.pid);
+        else
+          marker = eina_slstr_printf("<a href=%d>[-]</a> ", row.pid);
+
+        snprintf(row.command, sizeof(row.command), "%*s%s%s (%d threads)", node->depth * 2, "",
+                 marker, node->proc->command, row.numthreads);
+     }
+   else
+     {
+        snprintf(row.command, sizeof(row.command), "%*s%s", node->depth * 2, "", node->proc->command);
+     }
+
+   if (_fields_append(ui, &row))
+     _rows_append(ui, node->proc);
+}
+
+static void
+_tree_show(Ui *ui)
+{
+   Eina_List *l;
+   Eina_Hash *pids;
+   Proc_Stats *proc;
+   Tree_Node *nodes, *node, *parent;
+   const char *command;
+   int *order;
+   int i, j, k, n, count;
+
+   n = eina_list_count(ui->snapshot);
+   if (!n) return;
+
+   nodes = calloc(n, sizeof(Tree_Node));
+   order = malloc(n * sizeof(int));
+   pids = eina_hash_int32_new(NULL);
+
+   i = 0;
+   command = ui->snapshot_commands;
+   EINA_LIST_FOREACH (ui->snapshot, l, proc)
+     {
+        node = &nodes[i++];
+        node->proc = proc;
+        node->command_lower = command;
+        node->parent = node->first_child = node->next_sibling = node->depth = -1;
+        node->size = 1;
+        node->cpu_usage = proc->cpu_usage;
+        node->mem_rss = proc->mem_rss;
+        node->numthreads = proc->numthreads;
+        eina_hash_add(pids, &proc->pid, node);
+
+        command += strlen(command) + 1;
+     }
+
+   // Child index. Walking backwards and prepending keeps siblings in sort order.
+   for (i = n - 1; i >= 0; i--)
+     {
+        node = &nodes[i];
+        parent = eina_hash_find(pids, &node->proc->ppid);
+        if (!parent || parent == node) continue;
+
+        node->parent = parent - nodes;
+        node->next_sibling = parent->first_child;
+        parent->first_child = i;
+     }
+
+   // Pre-order walk from each root. Anything left unvisited is only
+   // reachable through a ppid loop (pid reuse during the scan) and is
+   // walked as a root of its own on a second pass.
+   count = 0;
+   for (int pass = 0; pass < 2; pass++)
+     {
+        for (i = 0; i < n; i++)
+          {
+             if (nodes[i].depth != -1) continue;
+             if (!pass && nodes[i].parent != -1) continue;
+
+             nodes[i].root = EINA_TRUE;
+             j = i;
+             while (1)
+               {
+                  node = &nodes[j];
+                  node->depth = (j == i) ? 0 : nodes[node->parent].depth + 1;
+                  order[count++] = j;
+
+                  if (node->first_child != -1 && nodes[node->first_child].depth == -1)
+                    {
+                       j = node->first_child;
+                       continue;
+                    }
+
+                  while (j != i && (nodes[j].next_sibling == -1 || nodes[nodes[j].next_sibling].depth != -1))
+                    j = nodes[j].parent;
+
+                  if (j == i) break;
+
+                  j = nodes[j].next_sibling;
+               }
+          }
+     }
+
+   // Subtree rollups, children before parents.
+   for (k = count - 1; k >= 0; k--)
+     {
+        node = &nodes[order[k]];
+        if (node->root) continue;
+
+        parent = &nodes[node->parent];
+        parent->cpu_usage += node->cpu_usage;
+        parent->mem_rss += node->mem_rss;
+        parent->numthreads += node->numthreads;
+        parent->size += node->size;
+     }
+
+   _tree_collapsed_prune(ui, pids);
+
+   k = 0;
+   while (k < count)
+     {
+        node = &nodes[order[k]];
+
+        if (!ui->filter || filter_match(ui->filter, node->proc, node->command_lower))
+          _tree_row_append(ui, node);
+
+        if (node->first_child != -1 && eina_hash_find(ui->tree_collapsed, &node->proc->pid))
+          k += node->size;
+        else
+          k++;
+     }
+
+   eina_hash_free(pids);
+   free(order);
+   free(nodes);
+}
+
+// A row of the grouped view. The row holds the totals of the group and
+// comes first so sorting a list of rows sorts the groups.
+typedef struct _Group
+{
+   Proc_Stats  row;
+   const char *name;
+   Eina_List  *members;
+   // Totals are read from cgroupfs rather than summed.
+   Cgroup     *cgroup;
+} Group;
+
+static const char *
+_group_name(Ui *ui, Proc_Stats *proc)
+{
+   switch (ui->group_by)
+     {
+      case GROUP_USER:
+        if (proc->user)
+          return proc->user;
+        return eina_slstr_printf("%d", proc->uid);
+
+      case GROUP_COMMAND:
+        return proc->command;
+
+      case GROUP_STATE:
+        return proc->state ? proc->state : "-";
+
+      case GROUP_CGROUP:
+        return proc->cgroup ? proc->cgroup : "-";
+
+      case GROUP_NAMESPACE:
+        return proc->ns ? proc->ns->name : "-";
+
+      default:
+        return NULL;
+     }
+}
+
+static void
+_group_add(Group *group, Proc_Stats *proc)
+{
+   Proc_Stats *row = &group->row;
+
+   if (!group->members)
+     {
+        *row = *proc;
+        row->numthreads = 0;
+        row->cpu_usage = 0;
+        row->mem_size = row->mem_rss = 0;
+        row->io_read_rate = row->io_write_rate = 0;
+        row->sched_delay = 0;
+        row->minflt_rate = row->majflt_rate = 0;
+        row->mem_pss = row->mem_uss = row->mem_swap = row->mem_anon_huge = 0;
+        row->mem_growth = 0;
+     }
+
+   group->members = eina_list_append(group->members, proc);
+
+   row->numthreads += proc->numthreads;
+   row->cpu_usage += proc->cpu_usage;
+   row->mem_size += proc->mem_size;
+   row->mem_rss += proc->mem_rss;
+   row->io_read_rate += proc->io_read_rate;
+   row->io_write_rate += proc->io_write_rate;
+   row->sched_delay += proc->sched_delay;
+   row->minflt_rate += proc->minflt_rate;
+   row->majflt_rate += proc->majflt_rate;
+   row->mem_growth += proc->mem_growth_valid ? proc->mem_growth : 0;
+
+   // Memory details are only shown when every member has them.
+   row->mem_detail &= proc->mem_detail;
+   row->mem_pss += proc->mem_pss;
+   row->mem_uss += proc->mem_uss;
+   row->mem_swap += proc->mem_swap;
+   row->mem_anon_huge += proc->mem_anon_huge;
+}
+
+static void
+_group_cgroup_append(char *text, size_t size, const Cgroup *cg)
+{
+   if (cg->memory_max >= 0)
+     eina_strlcat(text, eina_slstr_printf(", %lld of %lld K", (long long) cg->memory_current >> 10,
+                                          (long long) cg->memory_max >> 10), size);
+   if (cg->throttled > 0)
+     eina_strlcat(text, eina_slstr_printf(", throttled %.0f%%", cg->throttled), size);
+   if (cg->cpu_some > 0)
+     eina_strlcat(text, eina_slstr_printf(", cpu stalled %.1f%%", cg->cpu_some), size);
+   if (cg->memory_some > 0)
+     eina_strlcat(text, eina_slstr_printf(", memory stalled %.1f%%", cg->memory_some), size);
+   if (cg->io_some > 0)
+     eina_strlcat(text, eina_slstr_printf(", io stalled %.1f%%", cg->io_some), size);
+}
+
+static const char *
+_group_ns_label(const Group *group)
+{
+   const Eina_List *l;
+   const Proc_Stats *proc = eina_list_data_get(group->members);
+
+   if (!proc || !proc->ns)
+     return group->name;
+   if (proc->ns->host)
+     return eina_slstr_printf("host %s", group->name);
+
+   // A container is named after its init, pid 1 inside it.
+   EINA_LIST_FOREACH (group->members, l, proc)
+     {
+        if (proc->ns_pid == 1)
+          return eina_slstr_printf("%s %s", proc->command, group->name);
+     }
+
+   return group->name;
+}
+
+static int
+_group_anchor_add(Ui *ui, const char *name)
+{
+   Eina_Stringshare **names;
+
+   if (ui->group_names_count == ui->group_names_size)
+     {
+        names = realloc(ui->group_names, (ui->group_names_size + 64) * sizeof(Eina_Stringshare *));
+        if (!names) return -1;
+        ui->group_names = names;
+        ui->group_names_size += 64;
+     }
+
+   ui->group_names[ui->group_names_count] = eina_stringshare_add(name);
+
+   return ui->group_names_count++;
+}
+
+static void
+_group_anchors_clear(Ui *ui)
+{
+   for (int i = 0; i < ui->group_names_count; i++)
+     eina_stringshare_del(ui->group_names[i]);
+
+   ui->group_names_count = 0;
+}
+
+static void
+_group_show(Ui *ui)
+{
+   Eina_List *l, *list = NULL, *members;
+   const Eina_List *cl;
+   Eina_Hash *index;
+   Proc_Stats *proc, row;
+   Group *groups, *group;
+   const char *command = ui->snapshot_commands;
+   const char *name;
+   char *label;
+   Cgroup *cg;
+   Eina_Bool expanded;
+   int i, n, count = 0, anchor;
+
+   _group_anchors_clear(ui);
+
+   n = eina_list_count(ui->snapshot);
+   if (ui->group_by == GROUP_CGROUP)
+     n += eina_list_count(ui->cgroups);
+   if (!n) return;
+
+   groups = calloc(n, sizeof(Group));
+   if (!groups) return;
+
+   index = eina_hash_string_superfast_new(NULL);
+
+   // Every cgroup has a row, including those with no processes of their own.
+   if (ui->group_by == GROUP_CGROUP)
+     {
+        EINA_LIST_FOREACH (ui->cgroups, cl, cg)
+          {
+             group = &groups[count++];
+             group->name = eina_stringshare_add(cg->path);
+             group->cgroup = cg;
+             eina_hash_add(index, group->name, group);
+          }
+     }
+
+   // One pass over the snapshot, totals are kept as members are added.
+   EINA_LIST_FOREACH (ui->snapshot, l, proc)
+     {
+        const char *command_lower = command;
+
+        command += strlen(command) + 1;
+
+        if (ui->program_pid == proc->pid)
+          continue;
+        if (ui->filter && !filter_match(ui->filter, proc, command_lower))
+          continue;
+
+        name = _group_name(ui, proc);
+
+        group = eina_hash_find(index, name);
+        if (!group)
+          {
+             group = &groups[count++];
+             group->name = eina_stringshare_add(name);
+             eina_hash_add(index, group->name, group);
+          }
+
+        _group_add(group, proc);
+     }
+
+   for (i = 0; i < count; i++)
+     {
+        group = &groups[i];
+        cg = group->cgroup;
+
+        if (cg)
+          {
+             // While searching only show groups with matches.
+             if (ui->filter && !group->members)
+               continue;
+
+             if (!group->members)
+               {
+                  eina_strlcpy(group->row.command, cg->path, sizeof(group->row.command));
+                  group->row.state = "-";
+               }
+
+             group->row.cpu_usage = cg->cpu_usage / (ui->cpu_per_core ? 1 : ui->cpu_count);
+             group->row.mem_rss = cg->memory_current;
+          }
+
+        list = eina_list_append(list, &group->row);
+     }
+
+   // cgroup rows keep the tree pre-order; only their members are sorted.
+   if (ui->group_by != GROUP_CGROUP)
+     list = _list_sort(ui, list);
+
+   EINA_LIST_FREE (list, proc)
+     {
+        group = (Group *) proc;
+
+        expanded = eina_hash_find(ui->groups_expanded, group->name) != NULL;
+
+        anchor = _group_anchor_add(ui, group->name);
+
+        // Paths, user and command names can hold markup of their own.
+        label = elm_entry_utf8_to_markup(ui->group_by == GROUP_NAMESPACE ? _group_ns_label(group)
+                                                                          : group->name);
+
+        row = group->row;
+        cg = group->cgroup;
+        if (cg && !group->members)
+          snprintf(row.command, sizeof(row.command), "%*s%s", cg->depth * 2, "", label ? label : "");
+        else if (cg)
+          snprintf(row.command, sizeof(row.command), "%*s<a href=%d>%s</a> %s (%d processes)",
+                   cg->depth * 2, "", anchor, expanded ? "[-]" : "[+]", label ? label : "",
+                   eina_list_count(group->members));
+        else
+          snprintf(row.command, sizeof(row.command), "<a href=%d>%s</a> %s (%d processes, %d threads)",
+                   anchor, expanded ? "[-]" : "[+]", label ? label : "",
+                   eina_list_count(group->members), row.numthreads);
+        free(label);
+        if (cg)
+          _group_cgroup_append(row.command, sizeof(row.command), cg);
+        if (ui->group_by != GROUP_USER)
+          row.user = "-";
+        if (ui->group_by != GROUP_STATE)
+          row.state = "-";
+
+        // Empty cgroups have no process to fetch memory details for.
+        if (_fields_append(ui, &row))
+          _rows_append(ui, eina_list_data_get(group->members));
+
+        if (!expanded)
+          continue;
+
+        group->members = _list_sort(ui, group->members);
+        EINA_LIST_FOREACH (group->members, members, proc)
+          {
+             row = *proc;
+             snprintf(row.command, sizeof(row.command), "  %s", proc->command);
+             if (_fields_append(ui, &row))
+               _rows_append(ui, proc);
+          }
+     }
+
+   for (i = 0; i < count; i++)
+     {
+        eina_list_free(groups[i].members);
+        eina_stringshare_del(groups[i].name);
+     }
+
+   eina_hash_free(index);
+   free(groups);
+}
+
+static void
+_snapshot_render(Ui *ui)
+{
+   Eina_List *l;
+   Proc_Stats *proc;
+   const char *command = ui->snapshot_commands;
+
+   ui->rows_count = 0;
+
+   if (ui->group_by != GROUP_NONE)
+     {
+        _group_show(ui);
+        _fields_show(ui);
+        _fields_clear(ui);
+        return;
+     }
+
+   if (ui->tree_view)
+     {
+        _tree_show(ui);
+        _fields_show(ui);
+        _fields_clear(ui);
+        return;
+     }
+
+   EINA_LIST_FOREACH (ui->snapshot, l, proc)
+     {
+        const char *command_lower = command;
+
+        command += strlen(command) + 1;
+
+        if (ui->filter && !filter_match(ui->filter, proc, command_lower))
+          continue;
+
+        if (_fields_append(ui, proc))
+          _rows_append(ui, proc);
+     }
+
+   _fields_show(ui);
+   _fields_clear(ui);
+}
+
+#define ROWS_VISIBLE_GUESS 50
+
+// Read smaps_rollup for the rows in view. Returns EINA_TRUE if any were
+// (re)read and the table should be rendered again.
+static Eina_Bool
+_rows_memory_fetch(Ui *ui)
+{
+   Evas_Coord y, h, height;
+   Eina_Bool updated = EINA_FALSE;
+   double row_height;
+   int i, first, last;
+
+   if (!ui->show_memory || !ui->rows_count)
+     return EINA_FALSE;
+
+   elm_scroller_region_get(ui->scroller, NULL, &y, NULL, &h);
+   evas_object_geometry_get(ui->entry_pid, NULL, NULL, NULL, &height);
+
+   if (height > 0 && h > 0)
+     {
+        // Every row of the table has the same height.
+        row_height = (double) height / ui->rows_count;
+        first = y / row_height;
+        last = (y + h) / row_height + 1;
+     }
+   else
+     {
+        first = 0;
+        last = ROWS_VISIBLE_GUESS;
+     }
+
+   if (first < 0) first = 0;
+   if (last > ui->rows_count) last = ui->rows_count;
+
+   for (i = first; i < last; i++)
+     {
+        if (ui->rows[i] && proc_info_memory_get(ui->rows[i], EINA_TRUE))
+          updated = EINA_TRUE;
+     }
+
+   return updated;
+}
+
+static void
+_snapshot_show(Ui *ui)
+{
+   _snapshot_render(ui);
+
+   if (_rows_memory_fetch(ui))
+     _snapshot_render(ui);
+}
+
+// Rates are over the measured time between the two reads, so extra
+// refreshes and main loop stalls don't skew them. ncpu is 1 for CPU %
+// of a single core, or the number of CPUs for CPU % of the machine.
+static void
+_sample_update(Proc_Sample *sample, Proc_Stats *proc, unsigned int flags, int ncpu)
+{
+   double delay;
+
+   proc->cpu_usage = 0;
+   proc->io_read_rate = proc->io_write_rate = 0;
+   proc->sched_delay = 0;
+   proc->minflt_rate = proc->majflt_rate = 0;
+
+   delay = proc->timestamp - sample->time;
+
+   if (sample->pid == proc->pid && delay > 0)
+     {
+        if (proc->cpu_time > sample->cpu_time)
+          proc->cpu_usage = (proc->cpu_time - sample->cpu_time) / 10000.0 / delay / ncpu;
+        if (proc->minflt > sample->minflt)
+          proc->minflt_rate = (double) (proc->minflt - sample->minflt) / delay;
+        if (proc->majflt > sample->majflt)
+          proc->majflt_rate = (double) (proc->majflt - sample->majflt) / delay;
+
+        if ((flags & sample->flags) & PROC_INFO_FLAG_IO)
+          {
+             if (proc->io_read_bytes > sample->io_read_bytes)
+               proc->io_read_rate = (double) (proc->io_read_bytes - sample->io_read_bytes) / delay;
+             if (proc->io_write_bytes > sample->io_write_bytes)
+               proc->io_write_rate = (double) (proc->io_write_bytes - sample->io_write_bytes) / delay;
+          }
+
+        if ((flags & sample->flags) & PROC_INFO_FLAG_SCHED)
+          {
+             if (proc->sched_wait_time > sample->sched_wait_time)
+               proc->sched_delay = (proc->sched_wait_time - sample->sched_wait_time) / 1000000.0 / delay;
+          }
+     }
+
+   sample->pid = proc->pid;
+   sample->time = proc->timestamp;
+   sample->cpu_time = proc->cpu_time;
+   sample->flags = flags;
+   sample->io_read_bytes = proc->io_read_bytes;
+   sample->io_write_bytes = proc->io_write_bytes;
+   sample->sched_wait_time = proc->sched_wait_time;
+   sample->minflt = proc->minflt;
+   sample->majflt = proc->majflt;
+}
+
+static Eina_Bool
+_samples_stale_cb(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata)
+{
+   void **args = fdata;
+   Ui *ui = args[0];
+   Eina_List **stale = args[1];
+   Proc_Sample *sample = data;
+
+   if (sample->generation != ui->samples_generation)
+     *stale = eina_list_append(*stale, key);
+
+   return EINA_TRUE;
+}
+
+static void
+_samples_sweep(Ui *ui)
+{
+   Eina_List *stale = NULL;
+   void *args[2] = { ui, &stale };
+   const void *key;
+
+   eina_hash_foreach(ui->samples, _samples_stale_cb, args);
+
+   EINA_LIST_FREE (stale, key)
+     eina_hash_del_by_key(ui->samples, key);
+}
+
+static void
+_alerts_update(Ui *ui)
+{
+   const Alert_Status *status;
+   char buf[4096];
+   const char *value;
+   int i, active = 0;
+
+   if (!alert_count())
+     {
+        elm_object_text_set(ui->label_alerts, "no rules");
+        return;
+     }
+
+   buf[0] = '\0';
+
+   for (i = 0; i < alert_count(); i++)
+     {
+        status = alert_status_get(i);
+        if (!status->active) continue;
+
+        if (status->memory)
+          value = eina_slstr_printf("%.0f K", status->value / 1024);
+        else
+          value = eina_slstr_printf("%.1f", status->value);
+
+        if (active++)
+          eina_strlcat(buf, ", ", sizeof(buf));
+
+        if (!strncmp(status->metric, "process.", 8))
+          eina_strlcat(buf, eina_slstr_printf("%s %s (%s %d)", status->name, value, status->command, status->pid), sizeof(buf));
+        else
+          eina_strlcat(buf, eina_slstr_printf("%s %s", status->name, value), sizeof(buf));
+     }
+
+   if (active)
+     elm_object_text_set(ui->label_alerts, eina_slstr_printf("<color=#ff4040>%s</color>", buf));
+   else
+     elm_object_text_set(ui->label_alerts, eina_slstr_printf("all clear (%d rules)", alert_count()));
+}
+
+static void
+_system_process_list_feedback_cb(void *data, Ecore_Thread *thread EINA_UNUSED, void *msg)
+{
+   Ui *ui;
+   Eina_List *list, *l;
+   Proc_Stats *proc;
+   Proc_Sample *sample;
+   Eina_Bool memory, memory_sort, record;
+   float values[HISTORY_METRICS];
+   unsigned int flags = PROC_INFO_FLAG_NONE;
+
+   eina_lock_take(&_lock);
+
+   ui = data;
+
+   users_cache_check();
+
+   // /proc/<pid>/io is only read while something shows or uses it, disk
+   // I/O history is only recorded meanwhile. The panel reads its own
+   // process through proc_info_by_pid().
+   if (ui->show_io || alert_process_io_used() ||
+       ui->sort_type == SORT_BY_IO_READ || ui->sort_type == SORT_BY_IO_WRITE)
+     flags |= PROC_INFO_FLAG_IO;
+   if (ui->show_sched || ui->sort_type == SORT_BY_SCHED_DELAY)
+     flags |= PROC_INFO_FLAG_SCHED;
+   if (ui->group_by == GROUP_CGROUP)
+     flags |= PROC_INFO_FLAG_CGROUP;
+   if (ui->group_by == GROUP_NAMESPACE)
+     flags |= PROC_INFO_FLAG_NS;
+
+   proc_info_flags_set(flags);
+
+   // Sorting needs every process, otherwise only rows in view are read.
+   memory_sort = ui->sort_type == SORT_BY_PSS || ui->sort_type == SORT_BY_USS ||
+                 ui->sort_type == SORT_BY_SWAP || ui->sort_type == SORT_BY_ANON_HUGE;
+   memory = ui->show_memory || memory_sort;
+
+   list = proc_info_all_get();
+
+   if (ui->group_by == GROUP_CGROUP)
+     ui->cgroups = cgroup_update();
+
+   ui->samples_generation++;
+
+   // Only the regular polls go into the history, not refreshes
+   // requested by the UI.
+   record = msg != NULL;
+   if (record)
+     {
+        history_begin();
+        alert_begin();
+     }
+
+   EINA_LIST_FOREACH (list, l, proc)
+     {
+        proc->user = users_name_get(proc->uid);
+
+        sample = eina_hash_find(ui->samples, &proc->pid);
+        if (!sample)
+          {
+             sample = calloc(1, sizeof(Proc_Sample));
+             sample->pid = -1;
+             eina_hash_add(ui->samples, &proc->pid, sample);
+          }
+
+        _sample_update(sample, proc, flags, ui->cpu_per_core ? 1 : ui->cpu_count);
+        sample->generation = ui->samples_generation;
+
+        if (memory)
+          proc_info_memory_get(proc, memory_sort);
+
+        if (record)
+          {
+             values[HISTORY_CPU] = proc->cpu_usage;
+             values[HISTORY_RSS] = proc->mem_rss;
+             // 0 while I/O isn't read.
+             values[HISTORY_IO] = proc->io_read_rate + proc->io_write_rate;
+             history_add(proc->pid, proc->start_time, proc->timestamp, values);
+          }
+
+        proc->mem_growth_valid = history_rss_growth_get(proc->pid, proc->start_time, &proc->mem_growth);
+
+        if (record)
+          alert_process(proc);
+     }
+
+   _samples_sweep(ui);
+
+   if (record)
+     {
+        history_end();
+        alert_end();
+        _alerts_update(ui);
+     }
+
+   list = _list_sort(ui, list);
+
+   _snapshot_set(ui, list);
+   _snapshot_show(ui);
+
+   eina_lock_release(&_lock);
+}
+
+static void
+_system_process_list_update(Ui *ui)
+{
+   _system_process_list_feedback_cb(ui, NULL, NULL);
+}
+
+// Grouped rows are sorted as they are rendered, so there is no need to
+// read every process again.
+static void
+_sort_update(Ui *ui)
+{
+   if (ui->group_by == GROUP_NONE)
+     {
+        _system_process_list_update(ui);
+        return;
+     }
+
+   eina_lock_take(&_lock);
+   _snapshot_show(ui);
+   eina_lock_release(&_lock);
+}
+
+static void
+_users_resolved_cb(void *data)
+{
+   Ui *ui = data;
+
+   _system_process_list_update(ui);
+}
+
+static void
+_system_process_list(void *data, Ecore_Thread *thread)
+{
+   Ui *ui;
+   int i;
+
+   ui = data;
+
+   while (1)
+     {
+        ecore_thread_feedback(thread, ui);
+        for (i = 0; i < ui->poll_delay * 2; i++)
+          {
+             if (ecore_thread_check(thread))
+               return;
+             usleep(500000);
+          }
+     }
+}
+
+static void
+_thread_end_cb(void *data EINA_UNUSED, Ecore_Thread *thread)
+{
+   thread = NULL;
+}
+
+static void
+_thread_error_cb(void *data EINA_UNUSED, Ecore_Thread *thread)
+{
+   thread = NULL;
+}
+
+static char *
+_progress_mem_format_cb(double val)
+{
+   char buf[1024];
+
+   snprintf(buf, sizeof(buf), "%ld M out of %ld M", _memory_used, _memory_total);
+
+   return strdup(buf);
+}
+
+static void
+_progress_mem_format_free_cb(char *str)
+{
+   if (str)
+     free(str);
+}
+
+static void
+_btn_icon_state_set(Evas_Object *button, Eina_Bool reverse)
+{
+   Evas_Object *icon = elm_icon_add(button);
+   if (reverse)
+     elm_icon_standard_set(icon, "go-down");
+   else
+     elm_icon_standard_set(icon, "go-up");
+
+   elm_object_part_content_set(button, "icon", icon);
+   evas_object_show(icon);
+}
+
+static void
+_btn_pid_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_PID)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->btn_pid, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_PID;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_uid_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_UID)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->btn_uid, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_UID;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_user_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_USER)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->btn_user, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_USER;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+
+static void
+_btn_cpu_usage_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_CPU_USAGE)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->btn_cpu_usage, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_CPU_USAGE;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_io_read_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_IO_READ)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_io_read.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_IO_READ;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_io_write_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_IO_WRITE)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_io_write.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_IO_WRITE;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_pss_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_PSS)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_pss.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_PSS;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_uss_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_USS)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_uss.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_USS;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_swap_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_SWAP)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_swap.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_SWAP;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_anon_huge_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_ANON_HUGE)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_anon_huge.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_ANON_HUGE;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_sched_delay_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_SCHED_DELAY)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_sched_delay.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_SCHED_DELAY;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_minflt_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_MINFLT)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_minflt.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_MINFLT;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_majflt_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_MAJFLT)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_majflt.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_MAJFLT;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_rss_growth_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_RSS_GROWTH)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->column_rss_growth.btn, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_RSS_GROWTH;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_size_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_SIZE)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->btn_size, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_SIZE;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_rss_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_RSS)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->btn_rss, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_RSS;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_btn_cmd_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_CMD)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->btn_cmd, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_CMD;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
 }
 
 static void
-_system_process_list(void *data, Ecore_Thread *thread)
+_btn_state_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   if (ui->sort_type == SORT_BY_STATE)
+     ui->sort_reverse = !ui->sort_reverse;
+
+   _btn_icon_state_set(ui->btn_state, ui->sort_reverse);
+
+   ui->sort_type = SORT_BY_STATE;
+
+   _sort_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+}
+
+static void
+_entry_search_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
 {
    Ui *ui;
-   int i;
+   char *text;
 
    ui = data;
 
-   while (1)
+   text = elm_entry_markup_to_utf8(elm_object_text_get(obj));
+
+   eina_lock_take(&_lock);
+
+   filter_free(ui->filter);
+   ui->filter = filter_new(text);
+
+   _snapshot_show(ui);
+
+   eina_lock_release(&_lock);
+
+   free(text);
+}
+
+static void
+_column_add(Ui_Column *column, Evas_Object *parent, const char *title, int col)
+{
+   Evas_Object *button, *entry;
+
+   column->col = col;
+   column->visible = EINA_FALSE;
+
+   column->btn = button = elm_button_add(parent);
+   _btn_icon_state_set(button, EINA_FALSE);
+   evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(button, title);
+
+   column->btn_body = button = elm_button_add(parent);
+   _btn_icon_state_set(button, EINA_FALSE);
+   evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(button, title);
+
+   column->entry = entry = elm_entry_add(parent);
+   elm_entry_text_style_user_push(entry, "DEFAULT='font=default:style=default size=12 align=right'");
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_scrollable_set(entry, 0);
+   elm_entry_editable_set(entry, 0);
+}
+
+static void
+_column_visible_set(Ui *ui, Ui_Column *column, Eina_Bool visible)
+{
+   if (column->visible == visible)
+     return;
+
+   column->visible = visible;
+
+   if (visible)
      {
-        ecore_thread_feedback(thread, ui);
-        for (i = 0; i < ui->poll_delay * 2; i++)
-          {
-             if (ecore_thread_check(thread))
-               return;
-             usleep(500000);
-          }
+        elm_table_pack(ui->table_header, column->btn, column->col, 0, 1, 1);
+        elm_table_pack(ui->table_body, column->btn_body, column->col, 0, 1, 1);
+        elm_table_pack(ui->table_body, column->entry, column->col, 0, 1, 1);
+        evas_object_show(column->btn);
+        evas_object_show(column->entry);
+     }
+   else
+     {
+        elm_table_unpack(ui->table_header, column->btn);
+        elm_table_unpack(ui->table_body, column->btn_body);
+        elm_table_unpack(ui->table_body, column->entry);
+        evas_object_hide(column->btn);
+        evas_object_hide(column->entry);
      }
 }
 
 static void
-_thread_end_cb(void *data EINA_UNUSED, Ecore_Thread *thread)
+_check_tree_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
 {
-   thread = NULL;
+   Ui *ui = data;
+
+   eina_lock_take(&_lock);
+
+   ui->tree_view = elm_check_state_get(obj);
+   _snapshot_show(ui);
+
+   eina_lock_release(&_lock);
 }
 
+static const char *_group_labels[GROUP_TYPES] = {
+   "Group: none", "Group: user", "Group: command", "Group: state", "Group: cgroup",
+   "Group: container",
+};
+
 static void
-_thread_error_cb(void *data EINA_UNUSED, Ecore_Thread *thread)
+_btn_group_clicked_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
 {
-   thread = NULL;
+   Ui *ui = data;
+
+   eina_lock_take(&_lock);
+
+   ui->group_by = (ui->group_by + 1) % GROUP_TYPES;
+   elm_object_text_set(obj, _group_labels[ui->group_by]);
+
+   eina_hash_free_buckets(ui->groups_expanded);
+   _snapshot_show(ui);
+
+   eina_lock_release(&_lock);
+
+   // Cgroups aren't read outside of this mode, read them now rather
+   // than at the next poll.
+   if (ui->group_by == GROUP_CGROUP)
+     _system_process_list_update(ui);
+
+   elm_scroller_page_bring_in(ui->scroller, 0, 0);
 }
 
-static char *
-_progress_mem_format_cb(double val)
+static void
+_check_io_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
 {
-   char buf[1024];
+   Ui *ui = data;
 
-   snprintf(buf, sizeof(buf), "%ld M out of %ld M", _memory_used, _memory_total);
+   ui->show_io = elm_check_state_get(obj);
 
-   return strdup(buf);
+   _column_visible_set(ui, &ui->column_io_read, ui->show_io);
+   _column_visible_set(ui, &ui->column_io_write, ui->show_io);
+
+   _system_process_list_update(ui);
 }
 
 static void
-_progress_mem_format_free_cb(char *str)
+_check_memory_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
 {
-   if (str)
-     free(str);
+   Ui *ui = data;
+
+   ui->show_memory = elm_check_state_get(obj);
+
+   _column_visible_set(ui, &ui->column_pss, ui->show_memory);
+   _column_visible_set(ui, &ui->column_uss, ui->show_memory);
+   _column_visible_set(ui, &ui->column_swap, ui->show_memory);
+   _column_visible_set(ui, &ui->column_anon_huge, ui->show_memory);
+
+   _system_process_list_update(ui);
 }
 
 static void
-_btn_icon_state_set(Evas_Object *button, Eina_Bool reverse)
+_check_sched_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
 {
-   Evas_Object *icon = elm_icon_add(button);
-   if (reverse)
-     elm_icon_standard_set(icon, "go-down");
+   Ui *ui = data;
+
+   ui->show_sched = elm_check_state_get(obj);
+
+   _column_visible_set(ui, &ui->column_sched_delay, ui->show_sched);
+
+   _system_process_list_update(ui);
+}
+
+static void
+_check_faults_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   ui->show_faults = elm_check_state_get(obj);
+
+   _column_visible_set(ui, &ui->column_minflt, ui->show_faults);
+   _column_visible_set(ui, &ui->column_majflt, ui->show_faults);
+
+   _system_process_list_update(ui);
+}
+
+static void
+_check_history_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   ui->show_history = elm_check_state_get(obj);
+
+   _column_visible_set(ui, &ui->column_history, ui->show_history);
+
+   _system_process_list_update(ui);
+}
+
+static void
+_check_rss_growth_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   ui->show_rss_growth = elm_check_state_get(obj);
+
+   _column_visible_set(ui, &ui->column_rss_growth, ui->show_rss_growth);
+
+   _system_process_list_update(ui);
+}
+
+static void
+_check_cores_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   ui->show_cores = elm_check_state_get(obj);
+
+   if (ui->show_cores)
+     evas_object_show(ui->frame_cores);
    else
-     elm_icon_standard_set(icon, "go-up");
+     evas_object_hide(ui->frame_cores);
+}
 
-   elm_object_part_content_set(button, "icon", icon);
-   evas_object_show(icon);
+static void
+_check_disks_all_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   ui->disks_all = elm_check_state_get(obj);
 }
 
 static void
-_btn_pid_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_check_per_core_changed_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
 {
    Ui *ui = data;
 
-   if (ui->sort_type == SORT_BY_PID)
-     ui->sort_reverse = !ui->sort_reverse;
+   ui->cpu_per_core = elm_check_state_get(obj);
+
+   _system_process_list_update(ui);
+}
+
+static void
+_scroller_scroll_stop_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
+
+   eina_lock_take(&_lock);
+
+   if (_rows_memory_fetch(ui))
+     _snapshot_render(ui);
+
+   eina_lock_release(&_lock);
+}
+
+static void
+_entry_cmd_anchor_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info)
+{
+   Ui *ui;
+   Elm_Entry_Anchor_Info *info;
+   pid_t *pid;
+
+   ui = data;
+   info = event_info;
+
+   if (!info->name)
+     return;
+
+   if (ui->group_by != GROUP_NONE)
+     {
+        const char *name;
+        int i = atoi(info->name);
+
+        eina_lock_take(&_lock);
+
+        if (i >= 0 && i < ui->group_names_count)
+          {
+             name = ui->group_names[i];
+             if (!eina_hash_del_by_key(ui->groups_expanded, name))
+               eina_hash_add(ui->groups_expanded, name, strdup(name));
+             _snapshot_show(ui);
+          }
+
+        eina_lock_release(&_lock);
+        return;
+     }
+
+   if (!ui->tree_view)
+     return;
+
+   pid = malloc(sizeof(pid_t));
+   *pid = atoi(info->name);
+
+   eina_lock_take(&_lock);
+
+   if (!eina_hash_del_by_key(ui->tree_collapsed, pid))
+     eina_hash_add(ui->tree_collapsed, pid, pid);
+   else
+     free(pid);
+
+   _snapshot_show(ui);
+
+   eina_lock_release(&_lock);
+}
+
+static void
+_btn_quit_clicked_cb(void *data EINA_UNUSED, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   ecore_main_loop_quit();
+
+   elm_exit();
+}
+
+static void
+_btn_about_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui;
+   Evas_Object *win;
+
+   ui = data;
+   win = ui->win;
+
+   printf("(c) Copyright 2018. Alastair Poole <netstar@gmail.com>\n");
+}
+
+static void
+_list_item_del_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   pid_t *pid = data;
+
+   free(pid);
+}
+
+static void
+_process_panel_pids_update(Ui *ui)
+{
+   Proc_Stats *proc;
+   Elm_Widget_Item *item;
+   Eina_List *list;
+   pid_t *pid;
+   char buf[64];
+
+   if (!ui->panel_visible)
+     return;
+
+   // FIXME: something fishy going on here (mem-wise).
+   list = proc_info_all_get();
+   list = eina_list_sort(list, eina_list_count(list), _sort_by_pid);
+
+   elm_list_clear(ui->list_pid);
+
+   EINA_LIST_FREE(list, proc)
+     {
+        snprintf(buf, sizeof(buf), "%d", proc->pid);
+
+        pid = malloc(sizeof(pid_t));
+        *pid = proc->pid;
 
-   _btn_icon_state_set(ui->btn_pid, ui->sort_reverse);
+        item = elm_list_item_append(ui->list_pid, buf, NULL, NULL, NULL, pid);
+        elm_object_item_del_cb_set(item, _list_item_del_cb);
 
-   ui->sort_type = SORT_BY_PID;
+        free(proc);
+     }
 
-   _system_process_list_update(ui);
+   elm_list_go(ui->list_pid);
 
-   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+   if (list)
+     eina_list_free(list);
 }
 
 static void
-_btn_uid_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_process_panel_watch_update(Ui *ui)
 {
-   Ui *ui = data;
+   Watch_Sample samples[SPARKLINE_WIDTH];
+   double cpu[SPARKLINE_WIDTH], rss[SPARKLINE_WIDTH];
+   double cpu_max = 1.0, rss_min, rss_max;
+   int i, n, ncpu;
 
-   if (ui->sort_type == SORT_BY_UID)
-     ui->sort_reverse = !ui->sort_reverse;
+   if (!watch_exists(ui->selected_pid))
+     {
+        elm_object_text_set(ui->btn_watch, "Watch Process");
+        elm_object_text_set(ui->entry_pid_spark_cpu, "not watched");
+        elm_object_text_set(ui->entry_pid_spark_rss, "not watched");
+        return;
+     }
 
-   _btn_icon_state_set(ui->btn_uid, ui->sort_reverse);
+   elm_object_text_set(ui->btn_watch, "Unwatch Process");
 
-   ui->sort_type = SORT_BY_UID;
+   n = watch_samples_get(ui->selected_pid, samples, SPARKLINE_WIDTH);
+   if (!n)
+     return;
 
-   _system_process_list_update(ui);
+   ncpu = ui->cpu_per_core ? 1 : ui->cpu_count;
+   rss_min = rss_max = samples[0].mem_rss;
 
-   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+   for (i = 0; i < n; i++)
+     {
+        cpu[i] = samples[i].cpu_usage / ncpu;
+        if (cpu[i] > cpu_max) cpu_max = cpu[i];
+
+        rss[i] = samples[i].mem_rss;
+        if (rss[i] < rss_min) rss_min = rss[i];
+        if (rss[i] > rss_max) rss_max = rss[i];
+     }
+
+   elm_object_text_set(ui->entry_pid_spark_cpu, eina_slstr_printf("%s %.1f%%",
+                       _sparkline(cpu, n, 0, cpu_max), cpu[n - 1]));
+   elm_object_text_set(ui->entry_pid_spark_rss, eina_slstr_printf("%s %lld K",
+                       _sparkline(rss, n, rss_min, rss_max), (long long) samples[n - 1].mem_rss >> 10));
 }
 
+#define HISTORY_GRAPH_WIDTH  60
+#define HISTORY_GRAPH_HEIGHT 4
 
-static void
-_btn_cpu_usage_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+// A block graph of the averages, HISTORY_GRAPH_HEIGHT lines high, with
+// the points merged down to HISTORY_GRAPH_WIDTH columns, followed by the
+// minimum, average and maximum over the whole range.
+static const char *
+_history_graph(const History_Point *points, int n, double scale, const char *format)
 {
-   Ui *ui = data;
+   char buf[HISTORY_GRAPH_HEIGHT * (HISTORY_GRAPH_WIDTH * 4 + 4) + 1];
+   double values[HISTORY_GRAPH_WIDTH];
+   double min, max, sum, top = 0;
+   int i, j, row, cols, level, first, last;
 
-   if (ui->sort_type == SORT_BY_CPU_USAGE)
-     ui->sort_reverse = !ui->sort_reverse;
+   if (!n)
+     return "no history";
 
-   _btn_icon_state_set(ui->btn_cpu_usage, ui->sort_reverse);
+   cols = n < HISTORY_GRAPH_WIDTH ? n : HISTORY_GRAPH_WIDTH;
 
-   ui->sort_type = SORT_BY_CPU_USAGE;
+   min = points[0].min;
+   max = points[0].max;
+   sum = 0;
 
-   _system_process_list_update(ui);
+   for (i = 0; i < n; i++)
+     {
+        if (points[i].min < min) min = points[i].min;
+        if (points[i].max > max) max = points[i].max;
+        sum += points[i].avg;
+     }
 
-   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+   for (i = 0; i < cols; i++)
+     {
+        first = i * n / cols;
+        last = (i + 1) * n / cols;
+        values[i] = 0;
+        for (j = first; j < last; j++)
+          values[i] += points[j].avg;
+        values[i] /= last - first;
+        if (values[i] > top) top = values[i];
+     }
+
+   buf[0] = '\0';
+
+   for (row = HISTORY_GRAPH_HEIGHT - 1; row >= 0; row--)
+     {
+        for (i = 0; i < cols; i++)
+          {
+             level = 0;
+             if (top > 0)
+               level = values[i] / top * HISTORY_GRAPH_HEIGHT * 8 + 0.5;
+             level -= row * 8;
+
+             if (level <= 0)
+               eina_strlcat(buf, " ", sizeof(buf));
+             else
+               eina_strlcat(buf, _sparkline_glyphs[level > 8 ? 7 : level - 1], sizeof(buf));
+          }
+        eina_strlcat(buf, "<br>", sizeof(buf));
+     }
+
+   return eina_slstr_printf("%smin %s, avg %s, max %s", buf,
+                            eina_slstr_printf(format, min / scale),
+                            eina_slstr_printf(format, sum / n / scale),
+                            eina_slstr_printf(format, max / scale));
 }
 
 static void
-_btn_size_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_process_panel_history_update(Ui *ui, Proc_Stats *proc)
 {
-   Ui *ui = data;
-
-   if (ui->sort_type == SORT_BY_SIZE)
-     ui->sort_reverse = !ui->sort_reverse;
+   History_Point points[HISTORY_COARSE_SAMPLES];
+   int n, seconds;
 
-   _btn_icon_state_set(ui->btn_size, ui->sort_reverse);
+   switch (ui->history_tier)
+     {
+      case HISTORY_TIER_MEDIUM:
+        seconds = HISTORY_MEDIUM_SECONDS * HISTORY_MEDIUM_SAMPLES;
+        break;
 
-   ui->sort_type = SORT_BY_SIZE;
+      case HISTORY_TIER_COARSE:
+        seconds = HISTORY_COARSE_SECONDS * HISTORY_COARSE_SAMPLES;
+        break;
 
-   _system_process_list_update(ui);
+      default:
+        seconds = ui->poll_delay * HISTORY_FINE_SAMPLES;
+        break;
+     }
 
-   elm_scroller_page_bring_in(ui->scroller, 0, 0);
-}
+   if (seconds >= 7200)
+     elm_object_text_set(ui->btn_history_tier, eina_slstr_printf("Last %d hours", seconds / 3600));
+   else
+     elm_object_text_set(ui->btn_history_tier, eina_slstr_printf("Last %d minutes", seconds / 60));
 
-static void
-_btn_rss_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
-{
-   Ui *ui = data;
+   n = history_get(proc->pid, proc->start_time, ui->history_tier, HISTORY_CPU, points, HISTORY_COARSE_SAMPLES);
+   elm_object_text_set(ui->entry_pid_history_cpu, _history_graph(points, n, 1.0, "%.1f%%"));
 
-   if (ui->sort_type == SORT_BY_RSS)
-     ui->sort_reverse = !ui->sort_reverse;
+   n = history_get(proc->pid, proc->start_time, ui->history_tier, HISTORY_RSS, points, HISTORY_COARSE_SAMPLES);
+   elm_object_text_set(ui->entry_pid_history_rss, _history_graph(points, n, 1024.0, "%.0f K"));
 
-   _btn_icon_state_set(ui->btn_rss, ui->sort_reverse);
+   n = history_get(proc->pid, proc->start_time, ui->history_tier, HISTORY_IO, points, HISTORY_COARSE_SAMPLES);
+   elm_object_text_set(ui->entry_pid_history_io, _history_graph(points, n, 1024.0, "%.1f K/s"));
+}
 
-   ui->sort_type = SORT_BY_RSS;
+static int
+_thread_cpu_cmp(const void *p1, const void *p2)
+{
+   const Proc_Thread *t1 = p1, *t2 = p2;
 
-   _system_process_list_update(ui);
+   if (t1->cpu_usage > t2->cpu_usage) return -1;
+   if (t1->cpu_usage < t2->cpu_usage) return 1;
 
-   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+   return t1->tid - t2->tid;
 }
 
+#define THREADS_ROWS_MAX 500
+
 static void
-_btn_cmd_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_process_panel_threads_update(Ui *ui, Proc_Stats *proc)
 {
-   Ui *ui = data;
+   Eina_List *threads;
+   Proc_Thread *t;
+   char *text, *name;
+   char padded[32];
+   const char *row;
+   size_t len = 0;
+   int n, shown = 0, ncpu = ui->cpu_per_core ? 1 : ui->cpu_count;
+   Eina_Bool full = EINA_FALSE;
+
+   if (!ui->show_threads)
+     {
+        elm_object_text_set(ui->btn_threads, eina_slstr_printf("Show %d threads", proc->numthreads));
+        elm_object_text_set(ui->entry_pid_threads_list, "");
+        return;
+     }
 
-   if (ui->sort_type == SORT_BY_CMD)
-     ui->sort_reverse = !ui->sort_reverse;
+   threads = proc_info_threads_get(proc->pid);
+   n = eina_list_count(threads);
+   threads = eina_list_sort(threads, n, _thread_cpu_cmp);
 
-   _btn_icon_state_set(ui->btn_cmd, ui->sort_reverse);
+   elm_object_text_set(ui->btn_threads, eina_slstr_printf("Hide %d threads", n));
 
-   ui->sort_type = SORT_BY_CMD;
+   text = malloc(TEXT_FIELD_MAX);
+   if (text)
+     len = snprintf(text, TEXT_FIELD_MAX, "%7s %-16s %-6s %6s %4s %10s %10s<br>",
+                    "TID", "Name", "State", "CPU %", "CPU", "Voluntary", "Forced");
 
-   _system_process_list_update(ui);
+   // Sorted by CPU use, so the rows left out are the idlest.
+   EINA_LIST_FREE (threads, t)
+     {
+        if (text && !full)
+          {
+             // Threads name themselves, pad before escaping any markup.
+             snprintf(padded, sizeof(padded), "%-16.16s", t->name);
+             name = elm_entry_utf8_to_markup(padded);
+             row = eina_slstr_printf("%7d %s %-6s %6.1f %4d %10llu %10llu<br>",
+                                     t->tid, name ? name : "", t->state, t->cpu_usage / ncpu, t->cpu_id,
+                                     (unsigned long long) t->ctxt_voluntary,
+                                     (unsigned long long) t->ctxt_involuntary);
+             free(name);
+
+             // Leave room for the line counting the rest.
+             if (shown < THREADS_ROWS_MAX && len + strlen(row) < TEXT_FIELD_MAX - 64)
+               {
+                  len = eina_strlcat(text, row, TEXT_FIELD_MAX);
+                  shown++;
+               }
+             else
+               full = EINA_TRUE;
+          }
+        free(t);
+     }
 
-   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+   if (text)
+     {
+        if (shown < n)
+          eina_strlcat(text, eina_slstr_printf("… %d more<br>", n - shown), TEXT_FIELD_MAX);
+        elm_object_text_set(ui->entry_pid_threads_list, text);
+        free(text);
+     }
 }
 
+// The flag follows scrolling, which the toggle doesn't always cause.
+static Eina_Bool
+_process_panel_shown(Ui *ui)
+{
+   return !elm_panel_hidden_get(ui->panel);
+}
+
+#define FILES_ROWS_MAX 500
+
 static void
-_btn_state_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_process_panel_files_update(Ui *ui, Proc_Stats *proc)
 {
-   Ui *ui = data;
+   Eina_List *fds;
+   Proc_Fd *f;
+   char *text, *target;
+   const char *row;
+   size_t len = 0;
+   int64_t limit;
+   int n, shown = 0;
+   Eina_Bool full = EINA_FALSE;
+
+   if (!ui->show_files)
+     {
+        elm_object_text_set(ui->btn_files, "Show open files");
+        elm_object_text_set(ui->entry_pid_files_list, "");
+        return;
+     }
 
-   if (ui->sort_type == SORT_BY_STATE)
-     ui->sort_reverse = !ui->sort_reverse;
+   // The socket index is only kept while the list can be seen.
+   if (!_process_panel_shown(ui))
+     {
+        proc_info_fds_clear();
+        return;
+     }
 
-   _btn_icon_state_set(ui->btn_state, ui->sort_reverse);
+   fds = proc_info_fds_get(proc->pid, &limit);
+   n = eina_list_count(fds);
 
-   ui->sort_type = SORT_BY_STATE;
+   if (limit >= 0)
+     elm_object_text_set(ui->btn_files, eina_slstr_printf("Hide %d of %lld open files", n, (long long) limit));
+   else
+     elm_object_text_set(ui->btn_files, eina_slstr_printf("Hide %d open files", n));
 
-   _system_process_list_update(ui);
+   text = malloc(TEXT_FIELD_MAX);
+   if (text)
+     len = snprintf(text, TEXT_FIELD_MAX, "%5s %s<br>", "FD", "Target");
 
-   elm_scroller_page_bring_in(ui->scroller, 0, 0);
+   EINA_LIST_FREE(fds, f)
+     {
+        if (text && !full)
+          {
+             target = elm_entry_utf8_to_markup(f->target);
+             row = eina_slstr_printf("%5d %s<br>", f->fd, target ? target : "");
+             free(target);
+
+             // Leave room for the line counting the rest.
+             if (shown < FILES_ROWS_MAX && len + strlen(row) < TEXT_FIELD_MAX - 64)
+               {
+                  len = eina_strlcat(text, row, TEXT_FIELD_MAX);
+                  shown++;
+               }
+             else
+               full = EINA_TRUE;
+          }
+        free(f);
+     }
+
+   if (text)
+     {
+        if (shown < n)
+          eina_strlcat(text, eina_slstr_printf("… %d more<br>", n - shown), TEXT_FIELD_MAX);
+        elm_object_text_set(ui->entry_pid_files_list, text);
+        free(text);
+     }
 }
 
 static void
-_btn_quit_clicked_cb(void *data EINA_UNUSED, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_watch_updated_cb(void *data)
 {
-   ecore_main_loop_quit();
+   Ui *ui = data;
 
-   elm_exit();
+   if (ui->selected_pid != -1)
+     _process_panel_watch_update(ui);
 }
 
 static void
-_btn_about_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_btn_watch_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
 {
-   Ui *ui;
-   Evas_Object *win;
+   Ui *ui = data;
 
-   ui = data;
-   win = ui->win;
+   if (ui->selected_pid == -1)
+     return;
 
-   printf("(c) Copyright 2018. Alastair Poole <netstar@gmail.com>\n");
+   if (watch_exists(ui->selected_pid))
+     watch_del(ui->selected_pid);
+   else
+     watch_add(ui->selected_pid);
+
+   _process_panel_watch_update(ui);
 }
 
+// numa_maps makes the kernel walk every mapping, only read it while the
+// panel is open.
 static void
-_list_item_del_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_process_panel_numa_update(Ui *ui, Proc_Stats *proc)
 {
-   pid_t *pid = data;
+   uint64_t bytes[PROC_NUMA_NODES_MAX];
+   char text[1024];
+   int i, n;
 
-   free(pid);
+   if (!_process_panel_shown(ui))
+     return;
+
+   n = proc_info_numa_get(proc->pid, bytes, PROC_NUMA_NODES_MAX);
+   if (!n)
+     {
+        elm_object_text_set(ui->entry_pid_numa, "unavailable");
+        return;
+     }
+
+   text[0] = '\0';
+   for (i = 0; i < n; i++)
+     eina_strlcat(text, eina_slstr_printf("%snode%d %llu K", i ? ", " : "", i,
+                                          (unsigned long long) bytes[i] / 1024), sizeof(text));
+
+   elm_object_text_set(ui->entry_pid_numa, text);
 }
 
+static Eina_Bool _process_panel_update(void *data);
+
 static void
-_process_panel_pids_update(Ui *ui)
+_btn_threads_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
 {
-   Proc_Stats *proc;
-   Elm_Widget_Item *item;
-   Eina_List *list;
-   pid_t *pid;
-   char buf[64];
+   Ui *ui = data;
 
-   if (!ui->panel_visible)
-     return;
+   ui->show_threads = !ui->show_threads;
 
-   // FIXME: something fishy going on here (mem-wise).
-   list = proc_info_all_get();
-   list = eina_list_sort(list, eina_list_count(list), _sort_by_pid);
+   // Let go of the descriptors held for each thread.
+   if (!ui->show_threads)
+     proc_info_threads_clear();
 
-   elm_list_clear(ui->list_pid);
+   if (ui->selected_pid != -1)
+     _process_panel_update(ui);
+}
 
-   EINA_LIST_FREE(list, proc)
-     {
-        snprintf(buf, sizeof(buf), "%d", proc->pid);
+static void
+_btn_files_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
 
-        pid = malloc(sizeof(pid_t));
-        *pid = proc->pid;
+   ui->show_files = !ui->show_files;
 
-        item = elm_list_item_append(ui->list_pid, buf, NULL, NULL, NULL, pid);
-        elm_object_item_del_cb_set(item, _list_item_del_cb);
+   // Let go of the socket index.
+   if (!ui->show_files)
+     proc_info_fds_clear();
 
-        free(proc);
-     }
+   if (ui->selected_pid != -1)
+     _process_panel_update(ui);
+}
 
-   elm_list_go(ui->list_pid);
+static void
+_btn_history_tier_clicked_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Ui *ui = data;
 
-   if (list)
-     eina_list_free(list);
+   ui->history_tier = (ui->history_tier + 1) % HISTORY_TIERS;
+
+   if (ui->selected_pid != -1)
+     _process_panel_update(ui);
 }
 
 static Eina_Bool
@@ -605,15 +3144,16 @@ _process_panel_update(void *data)
    Ui *ui;
    const Eina_List *l, *list;
    Elm_Widget_Item *it;
-   struct passwd *pwd_entry;
+   const char *user;
    Proc_Stats *proc;
-   double cpu_usage = 0.0;
 
    ui = data;
 
    proc = proc_info_by_pid(ui->selected_pid);
    if (!proc)
      {
+        proc_info_threads_clear();
+        proc_info_fds_clear();
         _process_panel_pids_update(ui);
 
         return ECORE_CALLBACK_CANCEL;
@@ -632,27 +3172,66 @@ _process_panel_update(void *data)
 
    elm_object_text_set(ui->entry_pid_cmd, proc->command);
 
-   pwd_entry = getpwuid(proc->uid);
-   if (pwd_entry)
-     elm_object_text_set(ui->entry_pid_user, pwd_entry->pw_name);
+   user = users_name_get(proc->uid);
+   if (user)
+     elm_object_text_set(ui->entry_pid_user, user);
+   else
+     elm_object_text_set(ui->entry_pid_user, eina_slstr_printf("%d", proc->uid));
 
-   elm_object_text_set(ui->entry_pid_pid, eina_slstr_printf("%d", proc->pid));
+   if (proc->ns_pid && proc->ns_pid != proc->pid)
+     elm_object_text_set(ui->entry_pid_pid, eina_slstr_printf("%d (%d in its namespace)", proc->pid, proc->ns_pid));
+   else
+     elm_object_text_set(ui->entry_pid_pid, eina_slstr_printf("%d", proc->pid));
    elm_object_text_set(ui->entry_pid_uid, eina_slstr_printf("%d", proc->uid));
    elm_object_text_set(ui->entry_pid_cpu, eina_slstr_printf("%d", proc->cpu_id));
    elm_object_text_set(ui->entry_pid_threads, eina_slstr_printf("%d", proc->numthreads));
    elm_object_text_set(ui->entry_pid_size, eina_slstr_printf("%lld bytes", proc->mem_size));
-   elm_object_text_set(ui->entry_pid_rss, eina_slstr_printf("%lld bytes", proc->mem_rss));
+   if (history_rss_growth_get(proc->pid, proc->start_time, &proc->mem_growth))
+     elm_object_text_set(ui->entry_pid_rss, eina_slstr_printf("%lld bytes (%+lld K/h)", proc->mem_rss,
+                         (long long) proc->mem_growth >> 10));
+   else
+     elm_object_text_set(ui->entry_pid_rss, eina_slstr_printf("%lld bytes", proc->mem_rss));
    elm_object_text_set(ui->entry_pid_nice, eina_slstr_printf("%d", proc->nice));
    elm_object_text_set(ui->entry_pid_pri, eina_slstr_printf("%d", proc->priority));
    elm_object_text_set(ui->entry_pid_state, proc->state);
 
-   if (proc->cpu_time > ui->pid_cpu_time)
+   _sample_update(&ui->pid_sample, proc, PROC_INFO_FLAG_IO | PROC_INFO_FLAG_SCHED, ui->cpu_per_core ? 1 : ui->cpu_count);
+
+   elm_object_text_set(ui->entry_pid_cpu_usage, eina_slstr_printf("%.1f%%", proc->cpu_usage));
+   elm_object_text_set(ui->entry_pid_io_read, eina_slstr_printf("%llu bytes (%.1f K/s)",
+                       (unsigned long long) proc->io_read_bytes, proc->io_read_rate / 1024.0));
+   elm_object_text_set(ui->entry_pid_io_write, eina_slstr_printf("%llu bytes (%.1f K/s)",
+                       (unsigned long long) proc->io_write_bytes, proc->io_write_rate / 1024.0));
+   elm_object_text_set(ui->entry_pid_io_syscalls, eina_slstr_printf("%llu reads, %llu writes",
+                       (unsigned long long) proc->io_syscr, (unsigned long long) proc->io_syscw));
+   elm_object_text_set(ui->entry_pid_sched, eina_slstr_printf("%.2f ms/s (%llu timeslices)",
+                       proc->sched_delay, (unsigned long long) proc->sched_timeslices));
+   elm_object_text_set(ui->entry_pid_faults, eina_slstr_printf("%llu minor (%.1f/s), %llu major (%.1f/s)",
+                       (unsigned long long) proc->minflt, proc->minflt_rate,
+                       (unsigned long long) proc->majflt, proc->majflt_rate));
+
+   _process_panel_watch_update(ui);
+   _process_panel_history_update(ui, proc);
+   _process_panel_threads_update(ui, proc);
+   _process_panel_files_update(ui, proc);
+
+   proc_info_memory_get(proc, EINA_TRUE);
+   if (proc->mem_detail)
+     {
+        elm_object_text_set(ui->entry_pid_pss, eina_slstr_printf("%lld bytes", (long long) proc->mem_pss));
+        elm_object_text_set(ui->entry_pid_uss, eina_slstr_printf("%lld bytes", (long long) proc->mem_uss));
+        elm_object_text_set(ui->entry_pid_swap, eina_slstr_printf("%lld bytes", (long long) proc->mem_swap));
+        elm_object_text_set(ui->entry_pid_anon_huge, eina_slstr_printf("%lld bytes", (long long) proc->mem_anon_huge));
+     }
+   else
      {
-        cpu_usage = (double) (proc->cpu_time - ui->pid_cpu_time) / ui->poll_delay;
+        elm_object_text_set(ui->entry_pid_pss, "unavailable");
+        elm_object_text_set(ui->entry_pid_uss, "unavailable");
+        elm_object_text_set(ui->entry_pid_swap, "unavailable");
+        elm_object_text_set(ui->entry_pid_anon_huge, "unavailable");
      }
 
-   ui->pid_cpu_time = proc->cpu_time;
-   elm_object_text_set(ui->entry_pid_cpu_usage, eina_slstr_printf("%.1f%%", cpu_usage));
+   _process_panel_numa_update(ui, proc);
 
    free(proc);
 
@@ -688,11 +3267,14 @@ _process_panel_list_selected_cb(void *data, Evas_Object *obj, void *event_info E
 }
 
 static void
-_panel_scrolled_cb(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+_panel_scrolled_cb(void *data, Evas_Object *obj, void *event_info EINA_UNUSED)
 {
    Ui *ui = data;
 
    ui->panel_visible = !ui->panel_visible;
+
+   if (elm_panel_hidden_get(obj))
+     proc_info_fds_clear();
 }
 
 static void
@@ -788,7 +3370,7 @@ static void
 _ui_main_view_add(Evas_Object *parent, Ui *ui)
 {
    Evas_Object *box, *hbox, *frame, *table;
-   Evas_Object *progress, *button, *entry;
+   Evas_Object *progress, *button, *entry, *check, *label;
    Evas_Object *scroller;
 
    box = elm_box_add(parent);
@@ -834,7 +3416,134 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    elm_object_content_set(frame, progress);
    evas_object_show(progress);
 
-   table = elm_table_add(parent);
+   frame = elm_frame_add(hbox);
+   evas_object_size_hint_weight_set(frame, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(frame, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_object_text_set(frame, "Load");
+   elm_box_pack_end(hbox, frame);
+   evas_object_show(frame);
+
+   ui->label_activity = label = elm_label_add(parent);
+   evas_object_size_hint_weight_set(label, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(label, 0.5, 0.5);
+   elm_object_text_set(label, "-");
+   elm_object_content_set(frame, label);
+   evas_object_show(label);
+
+   frame = elm_frame_add(hbox);
+   evas_object_size_hint_weight_set(frame, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(frame, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_object_text_set(frame, "Temperature");
+   elm_box_pack_end(hbox, frame);
+   evas_object_show(frame);
+
+   ui->label_sensors = label = elm_label_add(parent);
+   evas_object_size_hint_weight_set(label, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(label, 0.5, 0.5);
+   elm_object_text_set(label, "-");
+   elm_object_content_set(frame, label);
+   evas_object_show(label);
+
+   frame = elm_frame_add(hbox);
+   evas_object_size_hint_weight_set(frame, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(frame, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_object_text_set(frame, "Power");
+   elm_box_pack_end(hbox, frame);
+   evas_object_show(frame);
+
+   ui->label_power = label = elm_label_add(parent);
+   evas_object_size_hint_weight_set(label, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(label, 0.5, 0.5);
+   elm_object_text_set(label, "-");
+   elm_object_content_set(frame, label);
+   evas_object_show(label);
+
+   frame = elm_frame_add(hbox);
+   evas_object_size_hint_weight_set(frame, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(frame, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_object_text_set(frame, "Pressure (avg10/avg60, stalled)");
+   elm_box_pack_end(hbox, frame);
+   evas_object_show(frame);
+
+   ui->label_pressure = label = elm_label_add(parent);
+   evas_object_size_hint_weight_set(label, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(label, 0.5, 0.5);
+   elm_object_text_set(label, "-");
+   elm_object_content_set(frame, label);
+   evas_object_show(label);
+
+   frame = elm_frame_add(hbox);
+   evas_object_size_hint_weight_set(frame, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(frame, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_object_text_set(frame, "Disks (read/write)");
+   elm_box_pack_end(hbox, frame);
+   evas_object_show(frame);
+
+   ui->label_disks = label = elm_label_add(parent);
+   evas_object_size_hint_weight_set(label, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(label, 0.5, 0.5);
+   elm_object_text_set(label, "-");
+   elm_object_content_set(frame, label);
+   evas_object_show(label);
+
+   frame = elm_frame_add(hbox);
+   evas_object_size_hint_weight_set(frame, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(frame, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_object_text_set(frame, "Run Queue Delay");
+   elm_box_pack_end(hbox, frame);
+   evas_object_show(frame);
+
+   ui->label_sched = label = elm_label_add(parent);
+   evas_object_size_hint_weight_set(label, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(label, 0.5, 0.5);
+   elm_object_text_set(label, "-");
+   elm_object_content_set(frame, label);
+   evas_object_show(label);
+
+   frame = elm_frame_add(hbox);
+   evas_object_size_hint_weight_set(frame, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(frame, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_object_text_set(frame, "Alerts");
+   elm_box_pack_end(hbox, frame);
+   evas_object_show(frame);
+
+   ui->label_alerts = label = elm_label_add(parent);
+   evas_object_size_hint_weight_set(label, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(label, 0.5, 0.5);
+   elm_object_text_set(label, "-");
+   elm_object_content_set(frame, label);
+   evas_object_show(label);
+
+   ui->frame_nodes = frame = elm_frame_add(box);
+   evas_object_size_hint_weight_set(frame, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(frame, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_object_text_set(frame, "NUMA Nodes");
+   elm_box_pack_end(box, frame);
+
+   ui->label_nodes = label = elm_label_add(parent);
+   evas_object_size_hint_weight_set(label, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(label, 0.0, 0.5);
+   elm_object_text_set(label, "-");
+   elm_object_content_set(frame, label);
+   evas_object_show(label);
+
+   ui->frame_cores = frame = elm_frame_add(box);
+   evas_object_size_hint_weight_set(frame, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(frame, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_object_text_set(frame, "CPU Cores");
+   elm_box_pack_end(box, frame);
+
+   ui->entry_cores = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_text_style_user_push(entry, "DEFAULT='font=Mono size=10'");
+   elm_entry_scrollable_set(entry, 0);
+   elm_entry_editable_set(entry, 0);
+   elm_object_text_set(entry, "-");
+   elm_object_content_set(frame, entry);
+   evas_object_show(entry);
+
+   ui->table_header = table = elm_table_add(parent);
    evas_object_size_hint_weight_set(table, EVAS_HINT_EXPAND, 0);
    evas_object_size_hint_align_set(table, EVAS_HINT_FILL, 0);
    elm_table_padding_set(table, 0, 0);
@@ -857,13 +3566,21 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    evas_object_show(button);
    elm_table_pack(table, button, 1, 0, 1, 1);
 
+   ui->btn_user = button = elm_button_add(parent);
+   _btn_icon_state_set(button, EINA_FALSE);
+   evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(button, "User");
+   evas_object_show(button);
+   elm_table_pack(table, button, 2, 0, 1, 1);
+
    ui->btn_size = button = elm_button_add(parent);
    _btn_icon_state_set(button, EINA_FALSE);
    evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
    elm_object_text_set(button, "Size");
    evas_object_show(button);
-   elm_table_pack(table, button, 2, 0, 1, 1);
+   elm_table_pack(table, button, 3, 0, 1, 1);
 
    ui->btn_rss = button = elm_button_add(parent);
    _btn_icon_state_set(button, EINA_FALSE);
@@ -871,7 +3588,7 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
    elm_object_text_set(button, "Res");
    evas_object_show(button);
-   elm_table_pack(table, button, 3, 0, 1, 1);
+   elm_table_pack(table, button, 4, 0, 1, 1);
 
    ui->btn_cmd = button = elm_button_add(parent);
    _btn_icon_state_set(button, EINA_FALSE);
@@ -879,7 +3596,7 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
    elm_object_text_set(button, "Command");
    evas_object_show(button);
-   elm_table_pack(table, button, 4, 0, 1, 1);
+   elm_table_pack(table, button, 5, 0, 1, 1);
 
    ui->btn_state = button = elm_button_add(parent);
    _btn_icon_state_set(button, EINA_FALSE);
@@ -887,7 +3604,7 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
    elm_object_text_set(button, "State");
    evas_object_show(button);
-   elm_table_pack(table, button, 5, 0, 1, 1);
+   elm_table_pack(table, button, 6, 0, 1, 1);
 
    ui->btn_cpu_usage = button = elm_button_add(parent);
    _btn_icon_state_set(button, EINA_FALSE);
@@ -895,9 +3612,9 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
    elm_object_text_set(button, "CPU %");
    evas_object_show(button);
-   elm_table_pack(table, button, 6, 0, 1, 1);
+   elm_table_pack(table, button, 7, 0, 1, 1);
 
-   table = elm_table_add(parent);
+   ui->table_body = table = elm_table_add(parent);
    evas_object_size_hint_weight_set(table, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
    evas_object_size_hint_align_set(table, EVAS_HINT_FILL, EVAS_HINT_EXPAND);
    elm_table_padding_set(table, 0, 0);
@@ -958,9 +3675,25 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    _btn_icon_state_set(button, EINA_FALSE);
    evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
-   elm_object_text_set(button, "Size");
+   elm_object_text_set(button, "User");
    elm_table_pack(table, button, 2, 0, 1, 1);
 
+   ui->entry_user = entry = elm_entry_add(parent);
+   elm_entry_text_style_user_push(entry, "DEFAULT='font=default:style=default size=12 align=center'");
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_scrollable_set(entry, 0);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_table_pack(table, entry, 2, 0, 1, 1);
+
+   button = elm_button_add(parent);
+   _btn_icon_state_set(button, EINA_FALSE);
+   evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(button, "Size");
+   elm_table_pack(table, button, 3, 0, 1, 1);
+
    ui->entry_size = entry = elm_entry_add(parent);
    elm_entry_text_style_user_push(entry, "DEFAULT='font=default:style=default size=12 align=right'");
    evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
@@ -968,14 +3701,14 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    elm_entry_scrollable_set(entry, 0);
    elm_entry_editable_set(entry, 0);
    evas_object_show(entry);
-   elm_table_pack(table, entry, 2, 0, 1, 1);
+   elm_table_pack(table, entry, 3, 0, 1, 1);
 
    button = elm_button_add(parent);
    _btn_icon_state_set(button, EINA_FALSE);
    evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
    elm_object_text_set(button, "Res");
-   elm_table_pack(table, button, 3, 0, 1, 1);
+   elm_table_pack(table, button, 4, 0, 1, 1);
 
    ui->entry_rss = entry = elm_entry_add(parent);
    elm_entry_text_style_user_push(entry, "DEFAULT='font=default:style=default size=12 align=right'");
@@ -984,14 +3717,14 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    elm_entry_scrollable_set(entry, 0);
    elm_entry_editable_set(entry, 0);
    evas_object_show(entry);
-   elm_table_pack(table, entry, 3, 0, 1, 1);
+   elm_table_pack(table, entry, 4, 0, 1, 1);
 
    button = elm_button_add(parent);
    _btn_icon_state_set(button, EINA_FALSE);
    evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
    elm_object_text_set(button, "Command");
-   elm_table_pack(table, button, 4, 0, 1, 1);
+   elm_table_pack(table, button, 5, 0, 1, 1);
 
    ui->entry_cmd = entry = elm_entry_add(parent);
    evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
@@ -999,14 +3732,14 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    elm_entry_scrollable_set(entry, 0);
    elm_entry_editable_set(entry, 0);
    evas_object_show(entry);
-   elm_table_pack(table, entry, 4, 0, 1, 1);
+   elm_table_pack(table, entry, 5, 0, 1, 1);
 
    button = elm_button_add(parent);
    _btn_icon_state_set(button, EINA_FALSE);
    evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
    elm_object_text_set(button, "State");
-   elm_table_pack(table, button, 5, 0, 1, 1);
+   elm_table_pack(table, button, 6, 0, 1, 1);
 
    ui->entry_state = entry = elm_entry_add(parent);
    elm_entry_text_style_user_push(entry, "DEFAULT='font=default:style=default size=12 align=center'");
@@ -1017,14 +3750,14 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    elm_entry_editable_set(entry, 0);
    elm_entry_line_wrap_set(entry, 1);
    evas_object_show(entry);
-   elm_table_pack(table, entry, 5, 0, 1, 1);
+   elm_table_pack(table, entry, 6, 0, 1, 1);
 
    button = elm_button_add(parent);
    _btn_icon_state_set(button, EINA_FALSE);
    evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
    elm_object_text_set(button, "CPU %");
-   elm_table_pack(table, button, 6, 0, 1, 1);
+   elm_table_pack(table, button, 7, 0, 1, 1);
 
    ui->entry_cpu_usage = entry = elm_entry_add(parent);
    elm_entry_text_style_user_push(entry, "DEFAULT='font=default:style=default size=12 align=center'");
@@ -1035,7 +3768,19 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    elm_entry_editable_set(entry, 0);
    elm_entry_line_wrap_set(entry, 1);
    evas_object_show(entry);
-   elm_table_pack(table, entry, 6, 0, 1, 1);
+   elm_table_pack(table, entry, 7, 0, 1, 1);
+
+   _column_add(&ui->column_io_read, parent, "IO Read", 8);
+   _column_add(&ui->column_io_write, parent, "IO Write", 9);
+   _column_add(&ui->column_pss, parent, "PSS", 10);
+   _column_add(&ui->column_uss, parent, "USS", 11);
+   _column_add(&ui->column_swap, parent, "Swap", 12);
+   _column_add(&ui->column_anon_huge, parent, "Huge", 13);
+   _column_add(&ui->column_sched_delay, parent, "Sched Delay", 14);
+   _column_add(&ui->column_minflt, parent, "MINFLT/s", 15);
+   _column_add(&ui->column_majflt, parent, "MAJFLT/s", 16);
+   _column_add(&ui->column_history, parent, "History", 17);
+   _column_add(&ui->column_rss_growth, parent, "RSS Growth", 18);
 
    hbox = elm_box_add(parent);
    evas_object_size_hint_weight_set(hbox, EVAS_HINT_EXPAND, 0);
@@ -1050,6 +3795,106 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
    elm_box_horizontal_set(box, EINA_TRUE);
    elm_box_pack_end(hbox, box);
 
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "Tree");
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_tree_changed_cb, ui);
+
+   ui->btn_group = button = elm_button_add(parent);
+   evas_object_size_hint_weight_set(button, 0, 0);
+   evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(button, _group_labels[GROUP_NONE]);
+   elm_box_pack_end(hbox, button);
+   evas_object_show(button);
+   evas_object_smart_callback_add(button, "clicked", _btn_group_clicked_cb, ui);
+
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "IO");
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_io_changed_cb, ui);
+
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "Memory");
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_memory_changed_cb, ui);
+
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "Sched");
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_sched_changed_cb, ui);
+
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "Faults");
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_faults_changed_cb, ui);
+
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "History");
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_history_changed_cb, ui);
+
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "Growth");
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_rss_growth_changed_cb, ui);
+
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "Cores");
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_cores_changed_cb, ui);
+
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "All disks");
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_disks_all_changed_cb, ui);
+
+   check = elm_check_add(parent);
+   evas_object_size_hint_weight_set(check, 0, 0);
+   evas_object_size_hint_align_set(check, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(check, "Per-core CPU %");
+   elm_check_state_set(check, ui->cpu_per_core);
+   elm_box_pack_end(hbox, check);
+   evas_object_show(check);
+   evas_object_smart_callback_add(check, "changed", _check_per_core_changed_cb, ui);
+
+   ui->entry_search = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, 0.5);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 1);
+   elm_object_part_text_set(entry, "guide", "Search: text, /regex/, user:name, uid:N, state:RUN, rss>1G, cpu>10");
+   elm_box_pack_end(hbox, entry);
+   evas_object_show(entry);
+   evas_object_smart_callback_add(entry, "changed,user", _entry_search_changed_cb, ui);
+
    button = elm_button_add(parent);
    evas_object_size_hint_weight_set(button, 0.1, 0);
    evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0);
@@ -1060,12 +3905,26 @@ _ui_main_view_add(Evas_Object *parent, Ui *ui)
 
    evas_object_smart_callback_add(ui->btn_pid, "clicked", _btn_pid_clicked_cb, ui);
    evas_object_smart_callback_add(ui->btn_uid, "clicked", _btn_uid_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->btn_user, "clicked", _btn_user_clicked_cb, ui);
    evas_object_smart_callback_add(ui->btn_size, "clicked", _btn_size_clicked_cb, ui);
    evas_object_smart_callback_add(ui->btn_rss, "clicked", _btn_rss_clicked_cb, ui);
    evas_object_smart_callback_add(ui->btn_cmd, "clicked", _btn_cmd_clicked_cb, ui);
    evas_object_smart_callback_add(ui->btn_state, "clicked", _btn_state_clicked_cb, ui);
    evas_object_smart_callback_add(ui->btn_cpu_usage, "clicked", _btn_cpu_usage_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_io_read.btn, "clicked", _btn_io_read_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_io_write.btn, "clicked", _btn_io_write_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_pss.btn, "clicked", _btn_pss_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_uss.btn, "clicked", _btn_uss_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_swap.btn, "clicked", _btn_swap_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_anon_huge.btn, "clicked", _btn_anon_huge_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_sched_delay.btn, "clicked", _btn_sched_delay_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_minflt.btn, "clicked", _btn_minflt_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_majflt.btn, "clicked", _btn_majflt_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->column_rss_growth.btn, "clicked", _btn_rss_growth_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->scroller, "scroll,anim,stop", _scroller_scroll_stop_cb, ui);
+   evas_object_smart_callback_add(ui->scroller, "scroll,drag,stop", _scroller_scroll_stop_cb, ui);
    evas_object_smart_callback_add(ui->entry_pid, "clicked", _entry_pid_clicked_cb, ui);
+   evas_object_smart_callback_add(ui->entry_cmd, "anchor,clicked", _entry_cmd_anchor_clicked_cb, ui);
 }
 
 static void
@@ -1333,12 +4192,285 @@ _ui_process_panel_add(Evas_Object *parent, Ui *ui)
    elm_entry_line_wrap_set(entry, 1);
    elm_table_pack(table, entry, 1, 11, 1, 1);
 
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Disk read:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 12, 1, 1);
+
+   ui->entry_pid_io_read = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 12, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Disk write:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 13, 1, 1);
+
+   ui->entry_pid_io_write = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 13, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "I/O syscalls:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 14, 1, 1);
+
+   ui->entry_pid_io_syscalls = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 14, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Proportional memory:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 15, 1, 1);
+
+   ui->entry_pid_pss = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 15, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Private memory:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 16, 1, 1);
+
+   ui->entry_pid_uss = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 16, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Swapped memory:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 17, 1, 1);
+
+   ui->entry_pid_swap = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 17, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Anon huge pages:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 18, 1, 1);
+
+   ui->entry_pid_anon_huge = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 18, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "NUMA pages:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 19, 1, 1);
+
+   ui->entry_pid_numa = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 19, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Sched delay:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 20, 1, 1);
+
+   ui->entry_pid_sched = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 20, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Page faults:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 21, 1, 1);
+
+   ui->entry_pid_faults = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 21, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "CPU % (live):");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 22, 1, 1);
+
+   ui->entry_pid_spark_cpu = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 22, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Resident (live):");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 23, 1, 1);
+
+   ui->entry_pid_spark_rss = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_single_line_set(entry, 1);
+   elm_entry_scrollable_set(entry, 1);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_entry_line_wrap_set(entry, 1);
+   elm_table_pack(table, entry, 1, 23, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "History range:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 24, 1, 1);
+
+   ui->btn_history_tier = button = elm_button_add(parent);
+   evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(button, 0.0, 0.5);
+   evas_object_show(button);
+   elm_table_pack(table, button, 1, 24, 1, 1);
+   evas_object_smart_callback_add(button, "clicked", _btn_history_tier_clicked_cb, ui);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "CPU % (history):");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 25, 1, 1);
+
+   ui->entry_pid_history_cpu = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_scrollable_set(entry, 0);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_table_pack(table, entry, 1, 25, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Resident (history):");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 26, 1, 1);
+
+   ui->entry_pid_history_rss = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_scrollable_set(entry, 0);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_table_pack(table, entry, 1, 26, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Disk I/O (history):");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 27, 1, 1);
+
+   ui->entry_pid_history_io = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_scrollable_set(entry, 0);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_table_pack(table, entry, 1, 27, 1, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Threads:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 28, 1, 1);
+
+   ui->btn_threads = button = elm_button_add(parent);
+   evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(button, 0.0, 0.5);
+   evas_object_show(button);
+   elm_table_pack(table, button, 1, 28, 1, 1);
+   evas_object_smart_callback_add(button, "clicked", _btn_threads_clicked_cb, ui);
+
+   ui->entry_pid_threads_list = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_text_style_user_push(entry, "DEFAULT='font=Mono size=10'");
+   elm_entry_scrollable_set(entry, 0);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_table_pack(table, entry, 0, 29, 2, 1);
+
+   label = elm_label_add(parent);
+   elm_object_text_set(label, "Files:");
+   evas_object_show(label);
+   elm_table_pack(table, label, 0, 30, 1, 1);
+
+   ui->btn_files = button = elm_button_add(parent);
+   evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(button, 0.0, 0.5);
+   evas_object_show(button);
+   elm_table_pack(table, button, 1, 30, 1, 1);
+   evas_object_smart_callback_add(button, "clicked", _btn_files_clicked_cb, ui);
+
+   ui->entry_pid_files_list = entry = elm_entry_add(parent);
+   evas_object_size_hint_weight_set(entry, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+   evas_object_size_hint_align_set(entry, EVAS_HINT_FILL, EVAS_HINT_FILL);
+   elm_entry_text_style_user_push(entry, "DEFAULT='font=Mono size=10'");
+   elm_entry_scrollable_set(entry, 0);
+   elm_entry_editable_set(entry, 0);
+   evas_object_show(entry);
+   elm_table_pack(table, entry, 0, 31, 2, 1);
+
    hbox = elm_box_add(parent);
    evas_object_size_hint_weight_set(hbox, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
    evas_object_size_hint_align_set(hbox, EVAS_HINT_FILL, EVAS_HINT_FILL);
    elm_box_horizontal_set(hbox, EINA_TRUE);
    evas_object_show(hbox);
-   elm_table_pack(table, hbox, 1, 12, 1, 1);
+   elm_table_pack(table, hbox, 1, 32, 1, 1);
 
    button = elm_button_add(parent);
    evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
@@ -1363,6 +4495,14 @@ _ui_process_panel_add(Evas_Object *parent, Ui *ui)
    elm_box_pack_end(hbox, button);
    evas_object_show(button);
    evas_object_smart_callback_add(button, "clicked", _btn_kill_clicked_cb, ui);
+
+   ui->btn_watch = button = elm_button_add(parent);
+   evas_object_size_hint_weight_set(button, EVAS_HINT_EXPAND, 0);
+   evas_object_size_hint_align_set(button, EVAS_HINT_FILL, 0.5);
+   elm_object_text_set(button, "Watch Process");
+   elm_box_pack_end(hbox, button);
+   evas_object_show(button);
+   evas_object_smart_callback_add(button, "clicked", _btn_watch_clicked_cb, ui);
 }
 
 void
@@ -1373,15 +4513,20 @@ ui_add(Evas_Object *parent)
 
    ui = calloc(1, sizeof(Ui));
    ui->win = parent;
-   ui->first_run = EINA_TRUE;
    ui->poll_delay = 3;
    ui->sort_reverse = EINA_FALSE;
    ui->sort_type = SORT_BY_PID;
    ui->selected_pid = -1;
    ui->program_pid = getpid();
-   ui->panel_visible = EINA_TRUE;
+   // The panel starts hidden.
+   ui->panel_visible = EINA_FALSE;
+   ui->cpu_per_core = EINA_TRUE;
+   ui->cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+   if (ui->cpu_count < 1)
+     ui->cpu_count = 1;
 
-   memset(ui->cpu_times, 0, PID_MAX * sizeof(int64_t));
+   ui->samples = eina_hash_int32_new(free);
+   ui->pid_sample.pid = -1;
 
    for (i = 0; i < PROCESS_INFO_FIELDS; i++)
      {
@@ -1391,6 +4536,12 @@ ui_add(Evas_Object *parent)
 
    eina_lock_new(&_lock);
 
+   ui->tree_collapsed = eina_hash_int32_new(free);
+   ui->groups_expanded = eina_hash_string_superfast_new(free);
+
+   users_resolved_cb_set(_users_resolved_cb, ui);
+   watch_updated_cb_set(_watch_updated_cb, ui);
+
    _ui_main_view_add(parent, ui);
    _ui_process_panel_add(parent, ui);
 
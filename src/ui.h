@@ -2,16 +2,31 @@
 #define __UI_H__
 
 #include <Elementary.h>
+#include "filter.h"
+#include "system.h"
+#include "history.h"
 
 typedef enum
 {
    PROCESS_INFO_FIELD_PID,
    PROCESS_INFO_FIELD_UID,
+   PROCESS_INFO_FIELD_USER,
    PROCESS_INFO_FIELD_SIZE,
    PROCESS_INFO_FIELD_RSS,
    PROCESS_INFO_FIELD_COMMAND,
    PROCESS_INFO_FIELD_STATE,
    PROCESS_INFO_FIELD_CPU_USAGE,
+   PROCESS_INFO_FIELD_IO_READ,
+   PROCESS_INFO_FIELD_IO_WRITE,
+   PROCESS_INFO_FIELD_PSS,
+   PROCESS_INFO_FIELD_USS,
+   PROCESS_INFO_FIELD_SWAP,
+   PROCESS_INFO_FIELD_ANON_HUGE,
+   PROCESS_INFO_FIELD_SCHED_DELAY,
+   PROCESS_INFO_FIELD_MINFLT,
+   PROCESS_INFO_FIELD_MAJFLT,
+   PROCESS_INFO_FIELD_HISTORY,
+   PROCESS_INFO_FIELD_RSS_GROWTH,
 
    // Not displayed in the main UI.
    PROCESS_INFO_FIELD_NICE,
@@ -22,13 +37,14 @@ typedef enum
    PROCESS_INFO_FIELD_CPU_TIME,
 } Proc_Stats_Field;
 
-#define PROCESS_INFO_FIELDS 7
+#define PROCESS_INFO_FIELDS 19
 
 typedef enum
 {
    SORT_BY_NONE,
    SORT_BY_PID,
    SORT_BY_UID,
+   SORT_BY_USER,
    SORT_BY_NICE,
    SORT_BY_PRI,
    SORT_BY_CPU,
@@ -38,8 +54,54 @@ typedef enum
    SORT_BY_CMD,
    SORT_BY_STATE,
    SORT_BY_CPU_USAGE,
+   SORT_BY_IO_READ,
+   SORT_BY_IO_WRITE,
+   SORT_BY_PSS,
+   SORT_BY_USS,
+   SORT_BY_SWAP,
+   SORT_BY_ANON_HUGE,
+   SORT_BY_SCHED_DELAY,
+   SORT_BY_MINFLT,
+   SORT_BY_MAJFLT,
+   SORT_BY_RSS_GROWTH,
 } Sort_Type;
 
+typedef enum
+{
+   GROUP_NONE,
+   GROUP_USER,
+   GROUP_COMMAND,
+   GROUP_STATE,
+   GROUP_CGROUP,
+   GROUP_NAMESPACE,
+   GROUP_TYPES,
+} Group_Type;
+
+// An optional column of the main view, packed only while visible.
+typedef struct Ui_Column
+{
+   Evas_Object *btn;
+   Evas_Object *btn_body;
+   Evas_Object *entry;
+   int          col;
+   Eina_Bool    visible;
+} Ui_Column;
+
+// Counters from the previous poll of a process.
+typedef struct Proc_Sample
+{
+   pid_t        pid;
+   unsigned int generation;
+   double       time;
+   int64_t      cpu_time;
+   unsigned int flags;
+   uint64_t     io_read_bytes;
+   uint64_t     io_write_bytes;
+   uint64_t     sched_wait_time;
+   uint64_t     minflt;
+   uint64_t     majflt;
+} Proc_Sample;
+
 typedef struct Ui
 {
    Evas_Object *win;
@@ -47,10 +109,25 @@ typedef struct Ui
    Evas_Object *scroller;
 
    Evas_Object *progress_cpu;
+   Evas_Object *frame_cores;
+   Evas_Object *entry_cores;
+   Evas_Object *frame_nodes;
+   Evas_Object *label_nodes;
    Evas_Object *progress_mem;
+   Evas_Object *label_sched;
+   Evas_Object *label_pressure;
+   Evas_Object *label_disks;
+   Evas_Object *label_activity;
+   Evas_Object *label_sensors;
+   Evas_Object *label_power;
+   Evas_Object *label_alerts;
+
+   Evas_Object *table_header;
+   Evas_Object *table_body;
 
    Evas_Object *entry_pid;
    Evas_Object *entry_uid;
+   Evas_Object *entry_user;
    Evas_Object *entry_size;
    Evas_Object *entry_rss;
    Evas_Object *entry_cmd;
@@ -59,12 +136,25 @@ typedef struct Ui
 
    Evas_Object *btn_pid;
    Evas_Object *btn_uid;
+   Evas_Object *btn_user;
    Evas_Object *btn_size;
    Evas_Object *btn_rss;
    Evas_Object *btn_cmd;
    Evas_Object *btn_state;
    Evas_Object *btn_cpu_usage;
 
+   Ui_Column    column_io_read;
+   Ui_Column    column_io_write;
+   Ui_Column    column_pss;
+   Ui_Column    column_uss;
+   Ui_Column    column_swap;
+   Ui_Column    column_anon_huge;
+   Ui_Column    column_sched_delay;
+   Ui_Column    column_minflt;
+   Ui_Column    column_majflt;
+   Ui_Column    column_history;
+   Ui_Column    column_rss_growth;
+
    Evas_Object *entry_pid_cmd;
    Evas_Object *entry_pid_user;
    Evas_Object *entry_pid_pid;
@@ -77,6 +167,27 @@ typedef struct Ui
    Evas_Object *entry_pid_pri;
    Evas_Object *entry_pid_state;
    Evas_Object *entry_pid_cpu_usage;
+   Evas_Object *entry_pid_io_read;
+   Evas_Object *entry_pid_io_write;
+   Evas_Object *entry_pid_io_syscalls;
+   Evas_Object *entry_pid_pss;
+   Evas_Object *entry_pid_uss;
+   Evas_Object *entry_pid_swap;
+   Evas_Object *entry_pid_anon_huge;
+   Evas_Object *entry_pid_numa;
+   Evas_Object *entry_pid_sched;
+   Evas_Object *entry_pid_faults;
+   Evas_Object *entry_pid_spark_cpu;
+   Evas_Object *entry_pid_spark_rss;
+   Evas_Object *btn_watch;
+   Evas_Object *btn_history_tier;
+   Evas_Object *entry_pid_history_cpu;
+   Evas_Object *entry_pid_history_rss;
+   Evas_Object *entry_pid_history_io;
+   Evas_Object *btn_threads;
+   Evas_Object *btn_files;
+   Evas_Object *entry_pid_threads_list;
+   Evas_Object *entry_pid_files_list;
 
    Ecore_Timer *timer_pid;
    pid_t        selected_pid;
@@ -87,13 +198,68 @@ typedef struct Ui
 
    Evas_Object *list_pid;
 
-   Eina_Bool    first_run;
+   Evas_Object *entry_search;
+   Filter      *filter;
+
+   Eina_Bool    tree_view;
+   Eina_Hash   *tree_collapsed;
+
+   Group_Type   group_by;
+   Eina_Hash   *groups_expanded;
+   // Group names by row anchor, as last rendered.
+   Eina_Stringshare **group_names;
+   int          group_names_count;
+   int          group_names_size;
+   Evas_Object *btn_group;
+   // From the last cgroup_update(), while grouping by cgroup.
+   const Eina_List *cgroups;
+
+   Eina_List   *snapshot;
+   char        *snapshot_commands;
+   size_t       snapshot_commands_size;
+
+   // Snapshot entries in display order, as last rendered.
+   Proc_Stats **rows;
+   int          rows_count;
+   int          rows_size;
+
+   Eina_Hash   *samples;
+   unsigned int samples_generation;
+   Proc_Sample  pid_sample;
+
+   Eina_Bool    show_io;
+   Eina_Bool    show_memory;
+   Eina_Bool    show_sched;
+   Eina_Bool    show_faults;
+   Eina_Bool    show_history;
+   Eina_Bool    show_rss_growth;
+   Eina_Bool    show_threads;
+   Eina_Bool    show_files;
+   Eina_Bool    show_cores;
+   // Include partitions and virtual block devices.
+   Eina_Bool    disks_all;
 
-   int64_t      cpu_times[PID_MAX];
-   int64_t      pid_cpu_time;
+   History_Tier history_tier;
+
+   Sys_Sched_Cpu *sched_prev;
+   int            sched_prev_count;
+   double         sched_prev_time;
+
+   Sys_Cpu       *cpu_times_prev;
+   int            cpu_times_prev_count;
+
+   Sys_Node      *nodes_prev;
+   int            nodes_prev_count;
+
+   Sys_Pressure   pressure_prev[SYS_PRESSURE_RESOURCES];
+   double         pressure_prev_time;
 
    int          poll_delay;
 
+   int          cpu_count;
+   // CPU % of one core, or of the whole machine.
+   Eina_Bool    cpu_per_core;
+
    Sort_Type    sort_type;
    Eina_Bool    sort_reverse;
    Eina_Bool    panel_visible;
@@ -104,8 +270,30 @@ typedef struct Sys_Stats
 {
    int    cpu_count;
    double cpu_usage;
-   long   mem_total;
-   long   mem_used;
+   double time;
+
+   Sys_Memory memory;
+
+   int            sensors_count;
+   Sys_Sensor    *sensors;
+
+   Sys_Power      power;
+
+   int            nodes_count;
+   Sys_Node      *nodes;
+
+   int            sched_count;
+   Sys_Sched_Cpu *sched;
+
+   int            cpu_times_count;
+   Sys_Cpu       *cpu_times;
+
+   Sys_Pressure   pressure[SYS_PRESSURE_RESOURCES];
+
+   int            disks_count;
+   Sys_Disk      *disks;
+
+   Sys_Activity   activity;
 } Sys_Stats;
 
 void
@@ -0,0 +1,226 @@
+#include "users.h"
+#include <Ecore.h>
+#include <Ecore_File.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pwd.h>
+
+#define PASSWD_PATH "/etc/passwd"
+
+typedef struct _User
+{
+   uid_t             uid;
+   Eina_Stringshare *name;
+} User;
+
+typedef struct _Users_Request
+{
+   unsigned int generation;
+   int          count;
+   uid_t       *uids;
+   char       **names;
+} Users_Request;
+
+static Eina_Hash    *_users = NULL;
+static Eina_List    *_pending = NULL;
+static Ecore_Thread *_thread = NULL;
+static long long     _passwd_mtime = 0;
+static unsigned int  _generation = 0;
+
+static void        (*_resolved_cb)(void *data) = NULL;
+static const void   *_resolved_data = NULL;
+
+static void
+_user_free(void *data)
+{
+   User *user = data;
+
+   eina_stringshare_del(user->name);
+   free(user);
+}
+
+static void
+_request_free(Users_Request *req)
+{
+   for (int i = 0; i < req->count; i++)
+     free(req->names[i]);
+
+   free(req->names);
+   free(req->uids);
+   free(req);
+}
+
+static void
+_resolve_run(void *data, Ecore_Thread *thread)
+{
+   Users_Request *req;
+   struct passwd pw, *result;
+   char *buf;
+   long size;
+
+   req = data;
+
+   size = sysconf(_SC_GETPW_R_SIZE_MAX);
+   if (size <= 0)
+     size = 16384;
+
+   buf = malloc(size);
+   if (!buf) return;
+
+   for (int i = 0; i < req->count; i++)
+     {
+        if (ecore_thread_check(thread))
+          break;
+
+        result = NULL;
+        if (!getpwuid_r(req->uids[i], &pw, buf, size, &result) && result)
+          req->names[i] = strdup(result->pw_name);
+     }
+
+   free(buf);
+}
+
+static void _resolve_start(void);
+
+static void
+_resolve_end_cb(void *data, Ecore_Thread *thread EINA_UNUSED)
+{
+   Users_Request *req;
+   User *user;
+
+   req = data;
+   _thread = NULL;
+
+   // Results from before a flush are stale, those UIDs get queued again.
+   if (_users && req->generation == _generation)
+     {
+        for (int i = 0; i < req->count; i++)
+          {
+             user = eina_hash_find(_users, &req->uids[i]);
+             if (!user) continue;
+
+             if (req->names[i])
+               user->name = eina_stringshare_add(req->names[i]);
+          }
+     }
+
+   _request_free(req);
+
+   if (!_users) return;
+
+   _resolve_start();
+
+   if (_resolved_cb)
+     _resolved_cb((void *) _resolved_data);
+}
+
+static void
+_resolve_cancel_cb(void *data, Ecore_Thread *thread EINA_UNUSED)
+{
+   _thread = NULL;
+
+   _request_free(data);
+}
+
+static void
+_resolve_start(void)
+{
+   Users_Request *req;
+   void *uid;
+   int i = 0;
+
+   if (_thread || !_pending)
+     return;
+
+   req = calloc(1, sizeof(Users_Request));
+   if (!req) return;
+
+   req->generation = _generation;
+   req->count = eina_list_count(_pending);
+   req->uids = malloc(req->count * sizeof(uid_t));
+   req->names = calloc(req->count, sizeof(char *));
+
+   EINA_LIST_FREE(_pending, uid)
+     {
+        req->uids[i++] = (uid_t) (uintptr_t) uid;
+     }
+
+   _thread = ecore_thread_run(_resolve_run, _resolve_end_cb, _resolve_cancel_cb, req);
+}
+
+void
+users_init(void)
+{
+   if (_users) return;
+
+   _users = eina_hash_int32_new(_user_free);
+   _passwd_mtime = ecore_file_mod_time(PASSWD_PATH);
+}
+
+void
+users_shutdown(void)
+{
+   if (_thread)
+     ecore_thread_cancel(_thread);
+
+   if (_pending)
+     _pending = eina_list_free(_pending);
+
+   if (_users)
+     eina_hash_free(_users);
+
+   _users = NULL;
+}
+
+void
+users_cache_check(void)
+{
+   long long mtime;
+
+   if (!_users) return;
+
+   mtime = ecore_file_mod_time(PASSWD_PATH);
+   if (mtime == _passwd_mtime)
+     return;
+
+   _passwd_mtime = mtime;
+   _generation++;
+
+   if (_pending)
+     _pending = eina_list_free(_pending);
+
+   eina_hash_free_buckets(_users);
+}
+
+void
+users_resolved_cb_set(void (*func)(void *data), const void *data)
+{
+   _resolved_cb = func;
+   _resolved_data = data;
+}
+
+const char *
+users_name_get(uid_t uid)
+{
+   User *user;
+
+   if (!_users) return NULL;
+
+   user = eina_hash_find(_users, &uid);
+   if (user)
+     return user->name;
+
+   user = calloc(1, sizeof(User));
+   if (!user) return NULL;
+
+   user->uid = uid;
+   eina_hash_add(_users, &user->uid, user);
+
+   _pending = eina_list_append(_pending, (void *) (uintptr_t) uid);
+   _resolve_start();
+
+   return NULL;
+}
@@ -0,0 +1,70 @@
+#ifndef __USERS_H__
+#define __USERS_H__
+
+/**
+ * @file
+ * @brief Cached user name lookups.
+ */
+
+/**
+ * @brief Resolving User Names
+ * @defgroup Users
+ *
+ * @{
+ *
+ * Map UIDs to user names without hitting NSS for every process on
+ * every poll. Each distinct UID is resolved once, in a worker thread,
+ * and the cache is dropped whenever /etc/passwd changes.
+ *
+ */
+
+#include <Eina.h>
+#include <sys/types.h>
+
+/**
+ * Initialize the user name cache.
+ */
+void
+users_init(void);
+
+/**
+ * Release the user name cache.
+ */
+void
+users_shutdown(void);
+
+/**
+ * Check /etc/passwd for modification and flush the cache if it has
+ * changed. Intended to be called once per poll, before any lookups.
+ */
+void
+users_cache_check(void);
+
+/**
+ * Set a callback to run in the main loop once a batch of pending UIDs
+ * has been resolved.
+ *
+ * @param func The function to call.
+ * @param data The data passed to func.
+ */
+void
+users_resolved_cb_set(void (*func)(void *data), const void *data);
+
+/**
+ * Look up the user name for a UID.
+ *
+ * This never blocks. An unknown UID is queued for resolution in a
+ * worker thread and NULL is returned until it has been resolved.
+ *
+ * @param uid The UID to look up.
+ *
+ * @return A stringshared user name or NULL if not (yet) known.
+ */
+const char *
+users_name_get(uid_t uid);
+
+/**
+ * @}
+ */
+
+#endif
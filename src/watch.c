@@ -0,0 +1,392 @@
+#include "watch.h"
+#include "process.h"
+#include <Ecore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#if defined(__linux__)
+# include <sys/timerfd.h>
+#endif
+
+typedef struct _Watch
+{
+   pid_t              pid;
+   unsigned long long start_time;
+   int                fd;
+   Eina_Bool          dead;
+
+   double             time;
+   int64_t            cpu_time;
+
+   int                head;
+   int                count;
+   Watch_Sample       samples[WATCH_SAMPLES];
+} Watch;
+
+static Eina_Lock     _lock;
+static Watch        *_watches[WATCH_MAX];
+static int           _count = 0;
+static Ecore_Thread *_thread = NULL;
+static Eina_Bool     _running = EINA_FALSE;
+
+static void        (*_updated_cb)(void *data) = NULL;
+static const void   *_updated_data = NULL;
+
+static double
+_watch_time(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static Watch *
+_watch_find(pid_t pid, int *index)
+{
+   for (int i = 0; i < _count; i++)
+     {
+        if (_watches[i]->pid == pid)
+          {
+             if (index) *index = i;
+             return _watches[i];
+          }
+     }
+
+   return NULL;
+}
+
+static void
+_watch_free(Watch *w)
+{
+   if (w->fd >= 0)
+     close(w->fd);
+
+   free(w);
+}
+
+#if defined(__linux__)
+
+static Eina_Bool
+_watch_read(Watch *w, unsigned long long *start_time, int64_t *cpu_time, int64_t *mem_rss)
+{
+   static long clk_tck = 0, pagesize = 0;
+   char path[64], buf[1024], *p;
+   unsigned long long utime, stime;
+   long long rss;
+   ssize_t bytes;
+
+   if (!clk_tck)
+     {
+        clk_tck = sysconf(_SC_CLK_TCK);
+        if (clk_tck <= 0) clk_tck = 100;
+        pagesize = getpagesize();
+     }
+
+   if (w->fd < 0)
+     {
+        snprintf(path, sizeof(path), "/proc/%d/stat", w->pid);
+        w->fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (w->fd < 0) return EINA_FALSE;
+     }
+
+   bytes = pread(w->fd, buf, sizeof(buf) - 1, 0);
+   if (bytes <= 0) return EINA_FALSE;
+   buf[bytes] = '\0';
+
+   // The command may contain spaces and parentheses, skip past the last ')'.
+   p = strrchr(buf, ')');
+   if (!p) return EINA_FALSE;
+
+   if (sscanf(p + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %*d %*d %*d %*d %*d %*d %llu %*u %lld",
+              &utime, &stime, start_time, &rss) != 4)
+     return EINA_FALSE;
+
+   *cpu_time = (int64_t) (utime + stime) * 1000000 / clk_tck;
+   *mem_rss = rss * pagesize;
+
+   return EINA_TRUE;
+}
+
+#else
+
+static Eina_Bool
+_watch_read(Watch *w, unsigned long long *start_time, int64_t *cpu_time, int64_t *mem_rss)
+{
+   Proc_Stats *proc;
+
+   proc = proc_info_by_pid(w->pid);
+   if (!proc) return EINA_FALSE;
+
+   *start_time = proc->start_time;
+   *cpu_time = proc->cpu_time;
+   *mem_rss = proc->mem_rss;
+
+   free(proc);
+
+   return EINA_TRUE;
+}
+
+#endif
+
+static void
+_watch_tick(void)
+{
+   Watch *w;
+   Watch_Sample *sample;
+   unsigned long long start_time;
+   int64_t cpu_time, mem_rss;
+   double now;
+
+   eina_lock_take(&_lock);
+
+   for (int i = 0; i < _count; i++)
+     {
+        w = _watches[i];
+        if (w->dead) continue;
+
+        now = _watch_time();
+
+        if (!_watch_read(w, &start_time, &cpu_time, &mem_rss) ||
+            (w->start_time && w->start_time != start_time))
+          {
+             // Exited, or exited and its pid was reused.
+             w->dead = EINA_TRUE;
+             continue;
+          }
+
+        if (w->start_time && now > w->time)
+          {
+             sample = &w->samples[w->head];
+             sample->time = now;
+             sample->cpu_usage = (cpu_time - w->cpu_time) / 10000.0 / (now - w->time);
+             sample->mem_rss = mem_rss;
+
+             w->head = (w->head + 1) % WATCH_SAMPLES;
+             if (w->count < WATCH_SAMPLES)
+               w->count++;
+          }
+
+        w->start_time = start_time;
+        w->cpu_time = cpu_time;
+        w->time = now;
+     }
+
+   eina_lock_release(&_lock);
+}
+
+// Redraws are requested at this rate, not at every sample.
+#define WATCH_UPDATE_HZ 4
+
+static void
+_watch_run(void *data EINA_UNUSED, Ecore_Thread *thread)
+{
+   unsigned int ticks = 0;
+#if defined(__linux__)
+   struct itimerspec its;
+   uint64_t expired;
+   int fd;
+
+   fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+   if (fd < 0) return;
+
+   its.it_interval.tv_sec = 0;
+   its.it_interval.tv_nsec = 1000000000 / WATCH_HZ;
+   its.it_value = its.it_interval;
+
+   if (timerfd_settime(fd, 0, &its, NULL) < 0)
+     {
+        close(fd);
+        return;
+     }
+#endif
+
+   while (!ecore_thread_check(thread))
+     {
+#if defined(__linux__)
+        if (read(fd, &expired, sizeof(expired)) != sizeof(expired))
+          {
+             if (errno == EINTR) continue;
+             break;
+          }
+#else
+        usleep(1000000 / WATCH_HZ);
+#endif
+        if (ecore_thread_check(thread))
+          break;
+
+        _watch_tick();
+
+        if (!(++ticks % (WATCH_HZ / WATCH_UPDATE_HZ)))
+          ecore_thread_feedback(thread, NULL);
+     }
+
+#if defined(__linux__)
+   close(fd);
+#endif
+}
+
+static void
+_watch_feedback_cb(void *data EINA_UNUSED, Ecore_Thread *thread EINA_UNUSED, void *msg EINA_UNUSED)
+{
+   if (_updated_cb)
+     _updated_cb((void *) _updated_data);
+}
+
+static void _watch_start(void);
+
+static void
+_watch_end_cb(void *data EINA_UNUSED, Ecore_Thread *thread EINA_UNUSED)
+{
+   _thread = NULL;
+
+   // Something was added again while the thread was stopping.
+   if (_running)
+     _watch_start();
+}
+
+static void
+_watch_start(void)
+{
+   if (_thread || !_running || !_count)
+     return;
+
+   _thread = ecore_thread_feedback_run(_watch_run, _watch_feedback_cb, _watch_end_cb, _watch_end_cb, NULL, EINA_FALSE);
+}
+
+void
+watch_init(void)
+{
+   if (_running) return;
+
+   eina_lock_new(&_lock);
+
+   _running = EINA_TRUE;
+}
+
+void
+watch_shutdown(void)
+{
+   if (!_running) return;
+
+   _running = EINA_FALSE;
+
+   if (_thread)
+     ecore_thread_cancel(_thread);
+
+   // The thread only touches the list with the lock held and checks
+   // for cancellation first, so it is safe to empty it here.
+   eina_lock_take(&_lock);
+
+   for (int i = 0; i < _count; i++)
+     _watch_free(_watches[i]);
+   _count = 0;
+
+   eina_lock_release(&_lock);
+}
+
+void
+watch_updated_cb_set(void (*func)(void *data), const void *data)
+{
+   _updated_cb = func;
+   _updated_data = data;
+}
+
+Eina_Bool
+watch_add(pid_t pid)
+{
+   Watch *w;
+
+   if (!_running) return EINA_FALSE;
+
+   eina_lock_take(&_lock);
+
+   if (_watch_find(pid, NULL))
+     {
+        eina_lock_release(&_lock);
+        return EINA_TRUE;
+     }
+
+   if (_count == WATCH_MAX || !(w = calloc(1, sizeof(Watch))))
+     {
+        eina_lock_release(&_lock);
+        return EINA_FALSE;
+     }
+
+   w->pid = pid;
+   w->fd = -1;
+   _watches[_count++] = w;
+
+   eina_lock_release(&_lock);
+
+   _watch_start();
+
+   return EINA_TRUE;
+}
+
+void
+watch_del(pid_t pid)
+{
+   Watch *w;
+   int i;
+
+   if (!_running) return;
+
+   eina_lock_take(&_lock);
+
+   w = _watch_find(pid, &i);
+   if (w)
+     {
+        _watch_free(w);
+        _watches[i] = _watches[--_count];
+     }
+
+   eina_lock_release(&_lock);
+
+   if (!_count && _thread)
+     ecore_thread_cancel(_thread);
+}
+
+Eina_Bool
+watch_exists(pid_t pid)
+{
+   Eina_Bool exists;
+
+   if (!_running) return EINA_FALSE;
+
+   eina_lock_take(&_lock);
+   exists = _watch_find(pid, NULL) != NULL;
+   eina_lock_release(&_lock);
+
+   return exists;
+}
+
+int
+watch_samples_get(pid_t pid, Watch_Sample *samples, int max)
+{
+   Watch *w;
+   int n = 0, start;
+
+   if (!_running) return 0;
+
+   eina_lock_take(&_lock);
+
+   w = _watch_find(pid, NULL);
+   if (w)
+     {
+        n = w->count < max ? w->count : max;
+        start = (w->head - n + WATCH_SAMPLES) % WATCH_SAMPLES;
+        for (int i = 0; i < n; i++)
+          samples[i] = w->samples[(start + i) % WATCH_SAMPLES];
+     }
+
+   eina_lock_release(&_lock);
+
+   return n;
+}
@@ -0,0 +1,104 @@
+#ifndef __WATCH_H__
+#define __WATCH_H__
+
+/**
+ * @file
+ * @brief High frequency sampling of a few processes.
+ */
+
+/**
+ * @brief Watching Processes
+ * @defgroup Watch
+ *
+ * @{
+ *
+ * Sample a short list of processes WATCH_HZ times a second, independently
+ * of the full process scan. Sampling runs in its own thread, driven by a
+ * timerfd where available, re-reading each process through a descriptor
+ * that is kept open. The thread only runs while something is watched.
+ *
+ */
+
+#include <Eina.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define WATCH_HZ      20
+#define WATCH_MAX     8
+// Five seconds worth of samples per process.
+#define WATCH_SAMPLES (WATCH_HZ * 5)
+
+typedef struct _Watch_Sample
+{
+   double  time;
+   double  cpu_usage;
+   int64_t mem_rss;
+} Watch_Sample;
+
+/**
+ * Initialize the watch list.
+ */
+void
+watch_init(void);
+
+/**
+ * Stop sampling and release the watch list.
+ */
+void
+watch_shutdown(void);
+
+/**
+ * Set a callback to run in the main loop, a few times a second, while
+ * new samples are being collected.
+ *
+ * @param func The function to call.
+ * @param data The data passed to func.
+ */
+void
+watch_updated_cb_set(void (*func)(void *data), const void *data);
+
+/**
+ * Start sampling a process.
+ *
+ * @param pid The process ID to watch.
+ *
+ * @return EINA_FALSE if the watch list is full.
+ */
+Eina_Bool
+watch_add(pid_t pid);
+
+/**
+ * Stop sampling a process and drop its samples.
+ *
+ * @param pid The process ID to stop watching.
+ */
+void
+watch_del(pid_t pid);
+
+/**
+ * Check whether a process is being watched.
+ *
+ * @param pid The process ID.
+ *
+ * @return EINA_TRUE if the process is on the watch list.
+ */
+Eina_Bool
+watch_exists(pid_t pid);
+
+/**
+ * Copy the most recent samples of a watched process, oldest first.
+ *
+ * @param pid The process ID.
+ * @param samples Where to store the samples.
+ * @param max The number of samples that fit in samples.
+ *
+ * @return The number of samples copied.
+ */
+int
+watch_samples_get(pid_t pid, Watch_Sample *samples, int max);
+
+/**
+ * @}
+ */
+
+#endif